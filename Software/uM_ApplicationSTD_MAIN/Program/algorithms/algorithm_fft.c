@@ -0,0 +1,206 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+
+#include "algorithm_fft.h"
+
+#include "arm_math.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define FFT_Q15(__X)  ((int16_t)__SSAT((int32_t)((__X) * 32768.0f), 16))
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Fft_Init
+**功能 : Hann Window and Twiddle Tables for a Real FFT of size Samples
+**輸入 : *pFft, size
+**輸出 : None
+**使用 : Fft_Init(&fft, 1024);  // float, once per mode change
+**====================================================================================================*/
+/*====================================================================================================*/
+void Fft_Init( Fft_Struct *pFft, uint16_t size )
+{
+  float rad = 0.0f;
+
+  if(size < FFT_SIZE_MIN) size = FFT_SIZE_MIN;
+  if(size > FFT_SIZE_MAX) size = FFT_SIZE_MAX;
+  while(size & (size - 1))
+    size &= size - 1;
+
+  pFft->Size = size;
+  pFft->Bits = 31 - __CLZ(size >> 1);
+
+  /* symmetric window, the second half reads the first one backwards */
+  for(uint16_t i = 0; i < size / 2; i++) {
+    rad = 2.0f * PI * i / size;
+    pFft->Window[i]  = FFT_Q15(0.5f - 0.5f * cosf(2.0f * PI * i / (size - 1)));
+    pFft->Twiddle[i] = (uint16_t)FFT_Q15(cosf(rad)) | ((uint32_t)(uint16_t)FFT_Q15(-sinf(rad)) << 16);
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Fft_Load
+**功能 : Remove DC, Window and Pack 12-bit Samples as Size / 2 Complex Points
+**輸入 : *pFft, *pData
+**輸出 : None
+**使用 : Fft_Load(&fft, capture);  // uint16_t capture[fft.Size]
+**====================================================================================================*/
+/*====================================================================================================*/
+void Fft_Load( Fft_Struct *pFft, const uint16_t *pData )
+{
+  uint16_t size = pFft->Size;
+  uint16_t half = size >> 1;
+  uint32_t sum = 0;
+  int32_t  mean = 0;
+  int32_t  data[2] = {0};
+
+  for(uint16_t i = 0; i < size; i++)
+    sum += pData[i];
+  mean = (int32_t)((sum << 2) / size);
+
+  /* q14 input, a complex point stays below 1.0 through every halving stage */
+  for(uint16_t i = 0, n = 0; i < half; i++) {
+    for(uint8_t j = 0; j < 2; j++, n++)
+      data[j] = ((((int32_t)pData[n] << 2) - mean) * pFft->Window[(n < half) ? n : size - 1 - n]) >> 15;
+    pFft->Data[i] = __PKHBT(data[0], data[1], 16);
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Fft_Run
+**功能 : Size / 2 Point Complex Radix-2 FFT, Split to the Real Spectrum, log2 Power per Bin
+**輸入 : *pFft
+**輸出 : None
+**使用 : Fft_Run(&fft);  // result in fft.Log[fft.Size / 2]
+**====================================================================================================*/
+/*====================================================================================================*/
+void Fft_Run( Fft_Struct *pFft )
+{
+  uint32_t *pData = pFft->Data;
+  uint16_t num = 1 << pFft->Bits;
+  uint16_t half = 0;
+  uint16_t step = 0;
+  uint16_t rev = 0;
+  uint32_t tmp = 0;
+  uint32_t w = 0;
+  int32_t  z[2], c[2], e[2], f[2], x[2];
+
+  /* bit reversed order */
+  for(uint16_t i = 1; i < num - 1; i++) {
+    rev = __RBIT(i) >> (32 - pFft->Bits);
+    if(rev > i) {
+      tmp = pData[i];
+      pData[i] = pData[rev];
+      pData[rev] = tmp;
+    }
+  }
+
+  /* one complex multiply in SMUSD / SMUADX, the halving add / sub in SHADD16 / SHSUB16 */
+  for(uint16_t len = 2; len <= num; len <<= 1) {
+    half = len >> 1;
+    step = pFft->Size / len;
+    for(uint16_t j = 0; j < half; j++) {
+      w = pFft->Twiddle[j * step];
+      for(uint16_t i = j; i < num; i += len) {
+        tmp = pData[i + half];
+        tmp = __PKHBT(__SMUSD(tmp, w) >> 15, __SMUADX(tmp, w) >> 15, 16);
+        pData[i + half] = __SHSUB16(pData[i], tmp);
+        pData[i] = __SHADD16(pData[i], tmp);
+      }
+    }
+  }
+
+  /* X[k] = (Z[k] + Z*[N-k]) / 2 - j W^k (Z[k] - Z*[N-k]) / 2 */
+  for(uint16_t k = 0; k < num; k++) {
+    z[0] = (int16_t)pData[k];
+    z[1] = (int16_t)(pData[k] >> 16);
+    c[0] = (int16_t)pData[(num - k) & (num - 1)];
+    c[1] = -(int16_t)(pData[(num - k) & (num - 1)] >> 16);
+    e[0] = (z[0] + c[0]) >> 1;
+    e[1] = (z[1] + c[1]) >> 1;
+    f[0] = (z[1] - c[1]) >> 1;
+    f[1] = (c[0] - z[0]) >> 1;
+    w = pFft->Twiddle[k];
+    x[0] = e[0] + (((int16_t)w * f[0] - (int16_t)(w >> 16) * f[1]) >> 15);
+    x[1] = e[1] + (((int16_t)w * f[1] + (int16_t)(w >> 16) * f[0]) >> 15);
+    pFft->Log[k] = Fft_log2Q8((uint32_t)(x[0] * x[0]) + (uint32_t)(x[1] * x[1]));
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Fft_Columns
+**功能 : Largest Bin per Display Column
+**輸入 : *pFft, *pCol, cols
+**輸出 : None
+**使用 : Fft_Columns(&fft, column, 94);  // log2 power Q8 per column
+**====================================================================================================*/
+/*====================================================================================================*/
+void Fft_Columns( Fft_Struct *pFft, uint16_t *pCol, uint8_t cols )
+{
+  uint16_t bins = pFft->Size >> 1;
+  uint16_t start = 0;
+  uint16_t end = 0;
+
+  /* max, not mean, a narrow line keeps its height when several bins share a column */
+  for(uint8_t i = 0; i < cols; i++) {
+    start = (uint32_t)i * bins / cols;
+    end   = (uint32_t)(i + 1) * bins / cols;
+    pCol[i] = 0;
+    for(uint16_t k = start; (k < end) || (k == start); k++)
+      if(pFft->Log[k] > pCol[i])
+        pCol[i] = pFft->Log[k];
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Fft_Peak
+**功能 : Largest Bin, DC Excluded, Parabolic Interpolation on the log Power
+**輸入 : *pFft
+**輸出 : bin, Q8
+**使用 : freq = ((uint64_t)Fft_Peak(&fft) * sampleRate / fft.Size) >> 8;
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t Fft_Peak( Fft_Struct *pFft )
+{
+  uint16_t bins = pFft->Size >> 1;
+  uint16_t peak = 1;
+  int32_t  delta = 0;
+  int32_t  denom = 0;
+
+  for(uint16_t k = 2; k < bins; k++)
+    if(pFft->Log[k] > pFft->Log[peak])
+      peak = k;
+
+  if(peak < bins - 1) {
+    denom = 2 * pFft->Log[peak] - pFft->Log[peak - 1] - pFft->Log[peak + 1];
+    if(denom > 0)
+      delta = (((int32_t)pFft->Log[peak + 1] - pFft->Log[peak - 1]) << 7) / denom;
+    if(delta >  128) delta =  128;
+    if(delta < -128) delta = -128;
+  }
+
+  return ((uint32_t)peak << 8) + delta;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Fft_log2Q8
+**功能 : log2, Linear between Powers of 2
+**輸入 : data
+**輸出 : log2(data), Q8, 0 - data is 0 or 1
+**使用 : log = Fft_log2Q8(power);
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t Fft_log2Q8( uint32_t data )
+{
+  uint8_t msb = 0;
+
+  if(data == 0)
+    return 0;
+
+  msb = 31 - __CLZ(data);
+  if(msb >= 8)
+    return (msb << 8) | ((data >> (msb - 8)) & 0xFF);
+
+  return (msb << 8) | ((data << (8 - msb)) & 0xFF);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
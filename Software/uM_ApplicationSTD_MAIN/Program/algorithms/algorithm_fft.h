@@ -0,0 +1,35 @@
+/* #include "algorithm_fft.h" */
+
+#ifndef __ALGORITHM_FFT_H
+#define __ALGORITHM_FFT_H
+
+#include "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define FFT_SIZE_MIN    256
+#define FFT_SIZE_MAX    1024                      // real samples
+#define FFT_BIN_MAX     (FFT_SIZE_MAX / 2)
+
+#define FFT_LOG_FULL    (24 << 8)                 // full scale sine, log2 of the bin power, Q8, noise floor near 1 << 8
+#define FFT_LOG_TO_DB(__LOG)  ((int32_t)(__LOG) * 301 / 25600)   // log2 power Q8 to dB
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  uint16_t Size;                        // real samples, power of 2
+  uint8_t  Bits;                        // log2(Size / 2)
+  int16_t  Window[FFT_SIZE_MAX / 2];    // Hann, first half, q15
+  uint32_t Twiddle[FFT_BIN_MAX];        // e^(-j 2 pi k / Size), cos | -sin << 16, q15
+  uint32_t Data[FFT_SIZE_MAX / 2];      // complex re | im << 16, q15, even / odd samples
+  uint16_t Log[FFT_BIN_MAX];            // log2 of the bin power, Q8
+} Fft_Struct;
+/*====================================================================================================*/
+/*====================================================================================================*/
+void     Fft_Init( Fft_Struct *pFft, uint16_t size );
+void     Fft_Load( Fft_Struct *pFft, const uint16_t *pData );
+void     Fft_Run( Fft_Struct *pFft );
+void     Fft_Columns( Fft_Struct *pFft, uint16_t *pCol, uint8_t cols );
+uint32_t Fft_Peak( Fft_Struct *pFft );
+uint16_t Fft_log2Q8( uint32_t data );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -0,0 +1,256 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+
+#include "algorithm_measure.h"
+#include "algorithm_rms.h"
+
+#include "arm_math.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define MEAS_MID_PAIR   0x08000800    // mid scale in both halfwords
+#define MEAS_SIGN_PAIR  0x80008000
+
+static uint32_t Meas_cross( uint16_t prev, uint16_t data, uint16_t level, uint32_t index )
+{
+  /* between sample index - 1 and index, linear, Q8 */
+  return ((index - 1) << 8) + (((int32_t)level - prev) << 8) / ((int32_t)data - prev);
+}
+
+static void Meas_rise( Meas_Struct *pMeas, uint32_t time )
+{
+  if(pMeas->FirstRise == MEAS_NONE)
+    pMeas->FirstRise = time;
+  else {
+    pMeas->Periods++;
+    pMeas->HighTime += pMeas->HighPart;
+  }
+  pMeas->LastRise = time;
+  pMeas->HighPart = 0;
+}
+
+static void Meas_fall( Meas_Struct *pMeas, uint32_t time )
+{
+  if(pMeas->FirstRise != MEAS_NONE)
+    pMeas->HighPart = time - pMeas->LastRise;
+}
+
+static void Meas_edge( Meas_Struct *pMeas, uint16_t data )
+{
+  uint16_t prev = pMeas->Last;
+  uint16_t *pLevel = pMeas->Level;
+  uint32_t *pCross = pMeas->Cross;
+
+  /* the 10 % and 90 % levels are the hysteresis, an edge ends only on the far one */
+  if(!pMeas->High) {
+    for(uint8_t k = 0; k < 3; k++)
+      if((prev < pLevel[k]) && (data >= pLevel[k]))
+        pCross[k] = Meas_cross(prev, data, pLevel[k], pMeas->Index);
+    if(data >= pLevel[2]) {
+      pMeas->High = 1;
+      if(pCross[0] != MEAS_NONE) {
+        pMeas->RiseSum += pCross[2] - pCross[0];
+        pMeas->RiseNum++;
+      }
+      if(pCross[1] != MEAS_NONE)
+        Meas_rise(pMeas, pCross[1]);
+      pCross[0] = pCross[1] = pCross[2] = MEAS_NONE;
+    }
+  }
+  else {
+    for(uint8_t k = 0; k < 3; k++)
+      if((prev > pLevel[k]) && (data <= pLevel[k]))
+        pCross[k] = Meas_cross(prev, data, pLevel[k], pMeas->Index);
+    if(data <= pLevel[0]) {
+      pMeas->High = 0;
+      if(pCross[2] != MEAS_NONE) {
+        pMeas->FallSum += pCross[0] - pCross[2];
+        pMeas->FallNum++;
+      }
+      if(pCross[1] != MEAS_NONE)
+        Meas_fall(pMeas, pCross[1]);
+      pCross[0] = pCross[1] = pCross[2] = MEAS_NONE;
+    }
+  }
+  pMeas->Last = data;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Meas_Init
+**功能 : No Levels yet, the First Pass Gives Statistics only
+**輸入 : *pMeas
+**輸出 : None
+**使用 : Meas_Init(&meas);
+**====================================================================================================*/
+/*====================================================================================================*/
+void Meas_Init( Meas_Struct *pMeas )
+{
+  pMeas->Valid = 0;
+  pMeas->Level[0] = pMeas->Level[1] = pMeas->Level[2] = 0;
+  Meas_Start(pMeas);
+  Meas_Finish(pMeas);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Meas_Start
+**功能 : Begin a Pass
+**輸入 : *pMeas
+**輸出 : None
+**使用 : Meas_Start(&meas);  // Meas_Push() per contiguous part, then Meas_Finish()
+**====================================================================================================*/
+/*====================================================================================================*/
+void Meas_Start( Meas_Struct *pMeas )
+{
+  pMeas->High      = 0;
+  pMeas->Last      = 0;
+  pMeas->Index     = 0;
+  pMeas->Sum       = 0;
+  pMeas->Pow       = 0;
+  pMeas->Max       = 0;
+  pMeas->Min       = UINT16_MAX;
+  pMeas->Cross[0]  = pMeas->Cross[1] = pMeas->Cross[2] = MEAS_NONE;
+  pMeas->FirstRise = MEAS_NONE;
+  pMeas->LastRise  = 0;
+  pMeas->HighTime  = 0;
+  pMeas->HighPart  = 0;
+  pMeas->Periods   = 0;
+  pMeas->RiseNum   = 0;
+  pMeas->FallNum   = 0;
+  pMeas->RiseSum   = 0;
+  pMeas->FallSum   = 0;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Meas_Push
+**功能 : Statistics Two Samples per Instruction, Edges only where the Signal Leaves Its Side
+**輸入 : *pMeas, *pData, lens
+**輸出 : None
+**使用 : Meas_Push(&meas, &ring[start], lens);  // 12-bit samples, contiguous with the last push
+**====================================================================================================*/
+/*====================================================================================================*/
+void Meas_Push( Meas_Struct *pMeas, const uint16_t *pData, uint32_t lens )
+{
+  uint32_t sum = pMeas->Sum;
+  int64_t  pow = pMeas->Pow;
+  uint32_t max2 = pMeas->Max * 0x00010001;
+  uint32_t min2 = pMeas->Min * 0x00010001;
+  uint32_t low2 = __PKHBT(-(int32_t)pMeas->Level[0], -(int32_t)pMeas->Level[0], 16);
+  uint32_t high2 = __PKHBT(-(int32_t)pMeas->Level[2] - 1, -(int32_t)pMeas->Level[2] - 1, 16);
+  uint32_t in32[4], d[4];
+  uint32_t i = 0;
+
+  if(pMeas->Index + lens > MEAS_LENS_MAX)
+    lens = (pMeas->Index < MEAS_LENS_MAX) ? MEAS_LENS_MAX - pMeas->Index : 0;
+  if(lens == 0)
+    return;
+
+  /* first sample of the pass sets the side */
+  if(pMeas->Index == 0) {
+    pMeas->High = pMeas->Valid && (pData[0] >= pMeas->Level[1]);
+    pMeas->Last = pData[0];
+  }
+
+  for(; i + 8 <= lens; i += 8) {
+    for(uint8_t k = 0; k < 4; k++) {
+      in32[k] = _SIMD32_OFFSET(&pData[i + 2 * k]);
+      sum = __SMLAD(in32[k], 0x00010001, sum);
+      d[k] = __SSUB16(in32[k], MEAS_MID_PAIR);
+      pow = (int64_t)__SMLALD(d[k], d[k], pow);
+      __USUB16(in32[k], max2);          // GE per halfword where the sample is larger
+      max2 = __SEL(in32[k], max2);
+      __USUB16(min2, in32[k]);
+      min2 = __SEL(in32[k], min2);
+    }
+    if(!pMeas->Valid) {
+      pMeas->Index += 8;
+      continue;
+    }
+
+    /* sign of sample - level per halfword, eight samples all on the present side skip the edge check */
+    if(!pMeas->High) {
+      for(uint8_t k = 0; k < 4; k++)
+        d[k] = __QADD16(in32[k], low2);
+      if((d[0] & d[1] & d[2] & d[3] & MEAS_SIGN_PAIR) == MEAS_SIGN_PAIR) {
+        pMeas->Index += 8;
+        pMeas->Last = pData[i + 7];
+        continue;
+      }
+    }
+    else {
+      for(uint8_t k = 0; k < 4; k++)
+        d[k] = __QADD16(in32[k], high2);
+      if(((d[0] | d[1] | d[2] | d[3]) & MEAS_SIGN_PAIR) == 0) {
+        pMeas->Index += 8;
+        pMeas->Last = pData[i + 7];
+        continue;
+      }
+    }
+    for(uint8_t k = 0; k < 8; k++) {
+      Meas_edge(pMeas, pData[i + k]);
+      pMeas->Index++;
+    }
+  }
+
+  /* tail */
+  pMeas->Max = ((max2 >> 16) > (max2 & 0xFFFF)) ? max2 >> 16 : max2 & 0xFFFF;
+  pMeas->Min = ((min2 >> 16) < (min2 & 0xFFFF)) ? min2 >> 16 : min2 & 0xFFFF;
+  for(; i < lens; i++) {
+    sum += pData[i];
+    pow += ((int32_t)pData[i] - 2048) * ((int32_t)pData[i] - 2048);
+    if(pData[i] > pMeas->Max) pMeas->Max = pData[i];
+    if(pData[i] < pMeas->Min) pMeas->Min = pData[i];
+    if(pMeas->Valid)
+      Meas_edge(pMeas, pData[i]);
+    pMeas->Index++;
+  }
+  pMeas->Sum = sum;
+  pMeas->Pow = pow;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Meas_Finish
+**功能 : Results of the Pass, Levels for the Next One
+**輸入 : *pMeas
+**輸出 : None
+**使用 : Meas_Finish(&meas);  // results in meas.Result
+**====================================================================================================*/
+/*====================================================================================================*/
+void Meas_Finish( Meas_Struct *pMeas )
+{
+  MeasResult_Struct *pResult = &pMeas->Result;
+  int64_t  num = pMeas->Index;
+  int64_t  sumMid = 0;
+  uint32_t span = 0;
+  uint16_t swing = 0;
+
+  if(num == 0) {
+    pResult->Max = pResult->Min = 0;
+    pResult->Mean = pResult->Rms = 0;
+    pResult->Period = pResult->Duty = 0;
+    pResult->Rise = pResult->Fall = 0;
+    return;
+  }
+
+  /* N * sum(d^2) - sum(d)^2 as in the RMS module, d around mid scale */
+  sumMid = (int64_t)pMeas->Sum - num * 2048;
+  pResult->Max  = pMeas->Max;
+  pResult->Min  = pMeas->Min;
+  pResult->Mean = (uint32_t)(((int64_t)pMeas->Sum << 8) / num);
+  pResult->Rms  = (uint32_t)Rms_sqrtQ30((uint32_t)((pMeas->Pow * num - sumMid * sumMid) / (num * num)) << 8) << 4;
+
+  span = pMeas->LastRise - pMeas->FirstRise;
+  pResult->Period = (pMeas->Periods != 0) ? span / pMeas->Periods : 0;
+  pResult->Duty   = (pMeas->Periods != 0) ? (uint16_t)((uint64_t)pMeas->HighTime * 1000 / span) : 0;
+  pResult->Rise   = (pMeas->RiseNum != 0) ? pMeas->RiseSum / pMeas->RiseNum : 0;
+  pResult->Fall   = (pMeas->FallNum != 0) ? pMeas->FallSum / pMeas->FallNum : 0;
+
+  swing = pMeas->Max - pMeas->Min;
+  pMeas->Valid = (pMeas->Max > pMeas->Min) && (swing >= MEAS_SWING_MIN);
+  if(pMeas->Valid) {
+    pMeas->Level[0] = pMeas->Min + swing / 10;
+    pMeas->Level[1] = pMeas->Min + swing / 2;
+    pMeas->Level[2] = pMeas->Max - swing / 10;
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
@@ -0,0 +1,55 @@
+/* #include "algorithm_measure.h" */
+
+#ifndef __ALGORITHM_MEASURE_H
+#define __ALGORITHM_MEASURE_H
+
+#include "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define MEAS_LENS_MAX   32768   // samples per pass, Sum stays in 32 bits
+#define MEAS_SWING_MIN  32      // ADC codes, max - min below this has no edges
+#define MEAS_NONE       0xFFFFFFFF
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  uint16_t Max;         // ADC code
+  uint16_t Min;
+  uint32_t Mean;        // ADC code, Q8
+  uint32_t Rms;         // AC part, DC removed, ADC code, Q8
+  uint32_t Period;      // samples, Q8, 0 - less than one period
+  uint16_t Duty;        // 0.1 %, 0 - no period
+  uint32_t Rise;        // 10 - 90 %, samples, Q8, 0 - no rising edge
+  uint32_t Fall;        // 90 - 10 %, samples, Q8, 0 - no falling edge
+} MeasResult_Struct;
+
+typedef struct {
+  uint16_t Level[3];    // 10, 50, 90 % of the last result
+  uint8_t  Valid;       // Level[] set, swing at least MEAS_SWING_MIN
+  uint8_t  High;        // last edge was rising
+  uint16_t Last;        // previous sample
+  uint32_t Index;       // samples so far, this pass
+  uint32_t Sum;
+  int64_t  Pow;         // sum of squares around mid scale
+  uint16_t Max;
+  uint16_t Min;
+  uint32_t Cross[3];    // last crossing of Level[], Q8, MEAS_NONE - not yet
+  uint32_t FirstRise;   // 50 % point of the first rising edge, Q8
+  uint32_t LastRise;
+  uint32_t HighTime;    // whole periods only, Q8
+  uint32_t HighPart;    // since LastRise
+  uint16_t Periods;
+  uint16_t RiseNum;
+  uint16_t FallNum;
+  uint32_t RiseSum;     // Q8
+  uint32_t FallSum;
+  MeasResult_Struct Result;
+} Meas_Struct;
+/*====================================================================================================*/
+/*====================================================================================================*/
+void Meas_Init( Meas_Struct *pMeas );
+void Meas_Start( Meas_Struct *pMeas );
+void Meas_Push( Meas_Struct *pMeas, const uint16_t *pData, uint32_t lens );
+void Meas_Finish( Meas_Struct *pMeas );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -0,0 +1,133 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+
+#include "algorithm_moveAve.h"
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : MoveAve_Init
+**功能 : Running Sum Average over 2^windowBits Samples, Optional EMA
+**輸入 : *pAve, windowBits, emaShift
+**輸出 : None
+**使用 : MoveAve_Init(&ave, 10, 4);  // 1024 samples, then EMA 1/16
+**====================================================================================================*/
+/*====================================================================================================*/
+void MoveAve_Init( MoveAve_Struct *pAve, uint8_t windowBits, uint8_t emaShift )
+{
+  if(windowBits < MOVEAVE_BITS_MIN) windowBits = MOVEAVE_BITS_MIN;
+  if(windowBits > MOVEAVE_BITS_MAX) windowBits = MOVEAVE_BITS_MAX;
+
+  for(uint16_t i = 0; i < MOVEAVE_SEG_MAX; i++)
+    pAve->SegSum[i] = 0;
+  pAve->SegHead    = 0;
+  pAve->SegNum     = 1 << (windowBits - MOVEAVE_BITS_MIN);
+  pAve->SegFill    = 0;
+  pAve->WindowBits = windowBits;
+  pAve->EmaShift   = emaShift;
+  pAve->Sum        = 0;
+  pAve->Acc        = 0;
+  pAve->AccCount   = 0;
+  pAve->Value      = 0;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : MoveAve_Push
+**功能 : Add Samples, O(1) per Sample
+**輸入 : *pAve, *pData, lens, stride
+**輸出 : None
+**使用 : MoveAve_Push(&ave, &block[0][1], ADC_BLOCK_SIZE, ADC_BUF_CHENNAL);
+**====================================================================================================*/
+/*====================================================================================================*/
+void MoveAve_Push( MoveAve_Struct *pAve, const uint16_t *pData, uint16_t lens, uint8_t stride )
+{
+  for(uint16_t i = 0; i < lens; i++, pData += stride) {
+    pAve->Acc += *pData;
+    if(++pAve->AccCount == MOVEAVE_SEG_SIZE)
+      MoveAve_PushSeg(pAve, pAve->Acc);
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : MoveAve_PushSeg
+**功能 : Add the Sum of MOVEAVE_SEG_SIZE Samples (Decimated by 16)
+**輸入 : *pAve, segSum
+**輸出 : None
+**使用 : MoveAve_PushSeg(&ave, sum16);
+**====================================================================================================*/
+/*====================================================================================================*/
+void MoveAve_PushSeg( MoveAve_Struct *pAve, uint32_t segSum )
+{
+  uint32_t mean = 0;
+
+  /* window slides by one segment, oldest partial sum out, newest in */
+  pAve->Sum += segSum - pAve->SegSum[pAve->SegHead];
+  pAve->SegSum[pAve->SegHead] = segSum;
+  pAve->SegHead = (pAve->SegHead + 1) & (pAve->SegNum - 1);
+  pAve->Acc = 0;
+  pAve->AccCount = 0;
+
+  if(pAve->SegFill < pAve->SegNum) {
+    pAve->SegFill++;
+    mean = (uint32_t)(((uint64_t)pAve->Sum << 16) / (pAve->SegFill * MOVEAVE_SEG_SIZE));
+  }
+  else
+    mean = pAve->Sum << (16 - pAve->WindowBits);
+
+  if((pAve->EmaShift == 0) || (pAve->SegFill == 1))
+    pAve->Value = mean;
+  else
+    pAve->Value = pAve->Value + (((int32_t)mean - (int32_t)pAve->Value) >> pAve->EmaShift);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : MoveAve_PushPair
+**功能 : Add Interleaved 12-bit Pairs to pAve[0] / pAve[1], SIMD Decimate by 16
+**輸入 : *pAve, *pPair, lens, stride (words from one pair to the next)
+**輸出 : None
+**使用 : MoveAve_PushPair(ave, (const uint32_t *)block, ADC_BLOCK_SIZE, 1);  // MoveAve_Struct ave[2]
+**====================================================================================================*/
+/*====================================================================================================*/
+void MoveAve_PushPair( MoveAve_Struct *pAve, const uint32_t *pPair, uint16_t lens, uint8_t stride )
+{
+  uint32_t acc = 0;
+
+  /* both halfwords add in one UADD16, 16 x 4095 still fits a 16-bit lane */
+  for(uint16_t i = 0; i < lens / MOVEAVE_SEG_SIZE; i++) {
+    acc = 0;
+    for(uint8_t j = 0; j < MOVEAVE_SEG_SIZE; j++, pPair += stride)
+      acc = __UADD16(acc, *pPair);
+    MoveAve_PushSeg(&pAve[0], acc & 0xFFFF);
+    MoveAve_PushSeg(&pAve[1], acc >> 16);
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : MoveAve_Get
+**功能 : Get Filtered Mean, No Loop
+**輸入 : *pAve
+**輸出 : mean
+**使用 : adc = MoveAve_Get(&ave);
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t MoveAve_Get( MoveAve_Struct *pAve )
+{
+  return (uint16_t)((pAve->Value + 0x8000) >> 16);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : MoveAve_GetBits
+**功能 : Get Filtered Mean with Extra Fraction Bits
+**輸入 : *pAve, bits
+**輸出 : mean * 2^bits
+**使用 : adc14 = MoveAve_GetBits(&ave, 2);
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t MoveAve_GetBits( MoveAve_Struct *pAve, uint8_t bits )
+{
+  if(bits >= 16)
+    return pAve->Value;
+
+  return (pAve->Value + (0x8000 >> bits)) >> (16 - bits);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
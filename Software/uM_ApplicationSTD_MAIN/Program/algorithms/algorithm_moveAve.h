@@ -0,0 +1,37 @@
+/* #include "algorithm_moveAve.h" */
+
+#ifndef __ALGORITHM_MOVEAVE_H
+#define __ALGORITHM_MOVEAVE_H
+
+#include "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define MOVEAVE_BITS_MIN  4                                 // window 16
+#define MOVEAVE_BITS_MAX  12                                // window 4096
+#define MOVEAVE_SEG_SIZE  (1 << MOVEAVE_BITS_MIN)           // samples per stored partial sum
+#define MOVEAVE_SEG_MAX   (1 << (MOVEAVE_BITS_MAX - MOVEAVE_BITS_MIN))
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  uint32_t SegSum[MOVEAVE_SEG_MAX];
+  uint16_t SegHead;     // oldest segment
+  uint16_t SegNum;      // window / MOVEAVE_SEG_SIZE
+  uint16_t SegFill;     // segments in window, SegNum when full
+  uint8_t  WindowBits;
+  uint8_t  EmaShift;    // 0 - off, else alpha = 1 / 2^EmaShift per segment
+  uint32_t Sum;         // sum of the window
+  uint32_t Acc;         // segment being filled
+  uint8_t  AccCount;
+  __IO uint32_t Value;  // filtered mean, Q16
+} MoveAve_Struct;
+/*====================================================================================================*/
+/*====================================================================================================*/
+void     MoveAve_Init( MoveAve_Struct *pAve, uint8_t windowBits, uint8_t emaShift );
+void     MoveAve_Push( MoveAve_Struct *pAve, const uint16_t *pData, uint16_t lens, uint8_t stride );
+void     MoveAve_PushSeg( MoveAve_Struct *pAve, uint32_t segSum );
+void     MoveAve_PushPair( MoveAve_Struct *pAve, const uint32_t *pPair, uint16_t lens, uint8_t stride );
+uint16_t MoveAve_Get( MoveAve_Struct *pAve );
+uint32_t MoveAve_GetBits( MoveAve_Struct *pAve, uint8_t bits );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -0,0 +1,151 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+
+#include "algorithm_peak.h"
+
+#include "arm_math.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+static uint32_t Peak_pair( uint32_t data )
+{
+  uint32_t swap = __ROR(data, 16);
+  uint32_t max2 = 0;
+  uint32_t min2 = 0;
+
+  /* GE per halfword where data is not below its swapped copy, both halves end up max or min */
+  __USUB16(data, swap);
+  max2 = __SEL(data, swap);
+  min2 = __SEL(swap, data);
+
+  return __PKHBT(~min2, max2, 0);
+}
+
+static uint16_t Peak_offset( Peak_Struct *pPeak, uint8_t level )
+{
+  uint16_t offset = 0;
+
+  for(uint8_t k = PEAK_LEVEL_MIN; k < level; k++)
+    offset += pPeak->Depth >> k;
+
+  return offset;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Peak_Start
+**功能 : Begin a Capture of depth Samples
+**輸入 : *pPeak, depth
+**輸出 : None
+**使用 : Peak_Start(&peak, 752);  // Peak_Push() per contiguous part, depth rounded down to 8 samples
+**====================================================================================================*/
+/*====================================================================================================*/
+void Peak_Start( Peak_Struct *pPeak, uint16_t depth )
+{
+  if(depth > PEAK_DEPTH_MAX)
+    depth = PEAK_DEPTH_MAX;
+
+  pPeak->Depth = depth & ~((1 << PEAK_LEVEL_MAX) - 1);
+  pPeak->Count = 0;
+  pPeak->Odd   = 0;
+  pPeak->Mark  = 0;
+  pPeak->Built = 0;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Peak_Push
+**功能 : Two Samples to One Min / Max Cell, the Only Pass over the Samples
+**輸入 : *pPeak, *pData, lens
+**輸出 : None
+**使用 : Peak_Push(&peak, &ring[start], lens);  // 12-bit samples, contiguous with the last push
+**====================================================================================================*/
+/*====================================================================================================*/
+void Peak_Push( Peak_Struct *pPeak, const uint16_t *pData, uint32_t lens )
+{
+  uint32_t *pCell = &pPeak->Cell[pPeak->Count >> 1];
+  uint32_t i = 0;
+
+  if(pPeak->Count + lens > pPeak->Depth)
+    lens = pPeak->Depth - pPeak->Count;
+  if(lens == 0)
+    return;
+
+  /* a ring wrap may split a pair */
+  if(pPeak->Count & 1) {
+    *pCell++ = Peak_pair(pPeak->Odd | ((uint32_t)pData[0] << 16));
+    i = 1;
+  }
+  for(; i + 4 <= lens; i += 4) {
+    pCell[0] = Peak_pair(_SIMD32_OFFSET(&pData[i]));
+    pCell[1] = Peak_pair(_SIMD32_OFFSET(&pData[i + 2]));
+    pCell += 2;
+  }
+  for(; i + 2 <= lens; i += 2)
+    *pCell++ = Peak_pair(_SIMD32_OFFSET(&pData[i]));
+  if(i < lens)
+    pPeak->Odd = pData[i];
+
+  pPeak->Count += lens;
+  if(pPeak->Count == pPeak->Depth)
+    pPeak->Built = PEAK_LEVEL_MIN;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Peak_Cells
+**功能 : Build the Levels up to level from the Cells below, Once per Capture
+**輸入 : *pPeak, level
+**輸出 : cells at level, 0 - capture not complete or level out of range
+**使用 : cells = Peak_Cells(&peak, 3);  // 8 samples per cell
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t Peak_Cells( Peak_Struct *pPeak, uint8_t level )
+{
+  uint32_t *pSrc = NULL;
+  uint32_t *pDst = NULL;
+  uint16_t num = 0;
+
+  if((level < PEAK_LEVEL_MIN) || (level > PEAK_LEVEL_MAX) || (pPeak->Built < PEAK_LEVEL_MIN))
+    return 0;
+
+  /* ~min is stored, one unsigned max per halfword merges max and min of two cells */
+  while(pPeak->Built < level) {
+    pSrc = &pPeak->Cell[Peak_offset(pPeak, pPeak->Built)];
+    num  = pPeak->Depth >> (pPeak->Built + 1);
+    pDst = &pSrc[num << 1];
+    for(uint16_t i = 0; i < num; i++) {
+      __USUB16(pSrc[2 * i], pSrc[2 * i + 1]);
+      pDst[i] = __SEL(pSrc[2 * i], pSrc[2 * i + 1]);
+    }
+    pPeak->Built++;
+  }
+
+  return pPeak->Depth >> level;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Peak_Columns
+**功能 : One Cell per Column, Max and Min of All the Samples behind It
+**輸入 : *pPeak, level, first, *pMax, *pMin, cols
+**輸出 : None
+**使用 : Peak_Columns(&peak, 2, 47, high, low, 94);  // 4 samples per column, first cell 47
+**====================================================================================================*/
+/*====================================================================================================*/
+void Peak_Columns( Peak_Struct *pPeak, uint8_t level, uint16_t first, uint16_t *pMax, uint16_t *pMin, uint16_t cols )
+{
+  uint16_t cells = Peak_Cells(pPeak, level);
+  const uint32_t *pCell = NULL;
+
+  if(cells == 0)
+    return;
+  if(cols > cells)
+    cols = cells;
+  if(first > cells - cols)
+    first = cells - cols;
+
+  pCell = &pPeak->Cell[Peak_offset(pPeak, level) + first];
+  for(uint16_t i = 0; i < cols; i++) {
+    pMax[i] = PEAK_MAX(pCell[i]);
+    pMin[i] = PEAK_MIN(pCell[i]);
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
@@ -0,0 +1,34 @@
+/* #include "algorithm_peak.h" */
+
+#ifndef __ALGORITHM_PEAK_H
+#define __ALGORITHM_PEAK_H
+
+#include "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define PEAK_LEVEL_MIN  1       // 2 samples per cell
+#define PEAK_LEVEL_MAX  3       // 8 samples per cell
+#define PEAK_DEPTH_MAX  768     // samples, multiple of 1 << PEAK_LEVEL_MAX
+#define PEAK_CELL_NUM   (PEAK_DEPTH_MAX / 2 + PEAK_DEPTH_MAX / 4 + PEAK_DEPTH_MAX / 8)
+
+#define PEAK_MAX(__CELL)  ((uint16_t)((__CELL) >> 16))
+#define PEAK_MIN(__CELL)  ((uint16_t)~(__CELL))
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  uint16_t Depth;       // samples per capture
+  uint16_t Count;       // samples pushed so far
+  uint16_t Odd;         // first sample of a pair split over two pushes
+  uint16_t Mark;        // sample of the trigger, the view keeps it in place over levels
+  uint8_t  Built;       // levels up to this one hold valid cells
+  uint32_t Cell[PEAK_CELL_NUM];   // max << 16 | ~min, level 1 first, each level half the one before
+} Peak_Struct;
+/*====================================================================================================*/
+/*====================================================================================================*/
+void     Peak_Start( Peak_Struct *pPeak, uint16_t depth );
+void     Peak_Push( Peak_Struct *pPeak, const uint16_t *pData, uint32_t lens );
+uint16_t Peak_Cells( Peak_Struct *pPeak, uint8_t level );
+void     Peak_Columns( Peak_Struct *pPeak, uint8_t level, uint16_t first, uint16_t *pMax, uint16_t *pMin, uint16_t cols );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -0,0 +1,235 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+
+#include "algorithm_rms.h"
+
+#include "arm_math.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+static void Rms_clear( RmsAcc_Struct *pAcc )
+{
+  pAcc->Pow = 0;
+  pAcc->Sum = 0;
+  pAcc->Num = 0;
+  pAcc->Max = INT16_MIN;
+  pAcc->Min = INT16_MAX;
+}
+
+static void Rms_merge( RmsAcc_Struct *pAcc, const RmsAcc_Struct *pAdd )
+{
+  pAcc->Pow += pAdd->Pow;
+  pAcc->Sum += pAdd->Sum;
+  pAcc->Num += pAdd->Num;
+  if(pAdd->Max > pAcc->Max) pAcc->Max = pAdd->Max;
+  if(pAdd->Min < pAcc->Min) pAcc->Min = pAdd->Min;
+}
+
+static void Rms_publish( Rms_Struct *pRms, const RmsAcc_Struct *pAcc, uint32_t period )
+{
+  int64_t  num = pAcc->Num;
+  int32_t  mean = 0;
+  uint32_t power = 0;
+  uint16_t peak = 0;
+
+  if(num == 0)
+    return;
+
+  /* N * sum(x^2) - sum(x)^2, DC removed without a second pass over the samples */
+  mean  = pAcc->Sum / (int32_t)num;
+  power = (uint32_t)((pAcc->Pow * num - (int64_t)pAcc->Sum * pAcc->Sum) / (num * num));
+  peak  = ((pAcc->Max - mean) > (mean - pAcc->Min)) ? pAcc->Max - mean : mean - pAcc->Min;
+
+  pRms->Result.Mean   = (int16_t)mean;
+  pRms->Result.Rms    = Rms_sqrtQ30(power);
+  pRms->Result.Peak   = peak;
+  pRms->Result.Period = period;
+  pRms->Count++;
+
+  /* next crossings on the new DC, noise under a quarter of the peak does not count */
+  pRms->Level = (int16_t)mean;
+  pRms->Hyst  = ((peak >> 2) > RMS_HYST_MIN) ? (peak >> 2) : RMS_HYST_MIN;
+}
+
+static void Rms_cross( Rms_Struct *pRms, uint16_t frac )
+{
+  if(pRms->Sync) {
+    Rms_merge(&pRms->Gate, &pRms->Part);
+    pRms->Periods++;
+    if(pRms->Gate.Num >= pRms->GateNum) {
+      Rms_publish(pRms, &pRms->Gate, ((pRms->Gate.Num << 8) + frac - pRms->GateFrac) / pRms->Periods);
+      Rms_clear(&pRms->Gate);
+      pRms->Periods = 0;
+      pRms->GateFrac = frac;
+    }
+  }
+  else {
+    pRms->Sync = 1;   // samples before the first crossing are no whole period
+    pRms->GateFrac = frac;
+  }
+  Rms_clear(&pRms->Part);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Rms_Init
+**功能 : True RMS over Whole Periods, DC Removed
+**輸入 : *pRms, gateNum
+**輸出 : None
+**使用 : Rms_Init(&rms, sampleRate / 10);  // a result about every 100 ms
+**====================================================================================================*/
+/*====================================================================================================*/
+void Rms_Init( Rms_Struct *pRms, uint32_t gateNum )
+{
+  if(gateNum < RMS_BLOCK_MAX) gateNum = RMS_BLOCK_MAX;
+  if(gateNum > RMS_GATE_MAX)  gateNum = RMS_GATE_MAX;
+
+  Rms_clear(&pRms->Gate);
+  Rms_clear(&pRms->Part);
+  pRms->GateNum  = gateNum;
+  pRms->GateFrac = 0;
+  pRms->Periods  = 0;
+  pRms->Sync     = 0;
+  pRms->Armed    = 0;
+  pRms->Level    = 0;
+  pRms->Hyst     = RMS_HYST_MIN;
+  pRms->Last     = 0;
+  pRms->Result.Mean   = 0;
+  pRms->Result.Rms    = 0;
+  pRms->Result.Peak   = 0;
+  pRms->Result.Period = 0;
+  pRms->Count    = 0;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Rms_Push
+**功能 : Add 12-bit Samples, Split at Rising Crossings of the DC Level
+**輸入 : *pRms, *pData, lens, stride
+**輸出 : None
+**使用 : Rms_Push(&rms, &block[0][0], ADC_BLOCK_SIZE, ADC_BUF_CHENNAL);  // in the DMA block callback
+**====================================================================================================*/
+/*====================================================================================================*/
+void Rms_Push( Rms_Struct *pRms, const uint16_t *pData, uint16_t lens, uint8_t stride )
+{
+  int16_t  buf[RMS_BLOCK_MAX];
+  int16_t  prev = pRms->Last;
+  int16_t  data = 0;
+  uint16_t start = 0;
+
+  if(lens > RMS_BLOCK_MAX)
+    lens = RMS_BLOCK_MAX;
+
+  /* q15 copy, crossings and peaks in one scalar pass, the sums in the SIMD kernel per segment */
+  for(uint16_t i = 0; i < lens; i++, pData += stride) {
+    data = RMS_ADCtoQ15(*pData);
+    buf[i] = data;
+
+    if(data < pRms->Level - pRms->Hyst)
+      pRms->Armed = 1;
+    else if(pRms->Armed && (data >= pRms->Level)) {
+      Rms_sumQ15(&buf[start], i - start, &pRms->Part.Sum, &pRms->Part.Pow);
+      pRms->Part.Num += i - start;
+      start = i;
+      Rms_cross(pRms, (uint16_t)((((int32_t)pRms->Level - prev) << 8) / (data - prev)));
+      pRms->Armed = 0;
+    }
+    if(data > pRms->Part.Max) pRms->Part.Max = data;
+    if(data < pRms->Part.Min) pRms->Part.Min = data;
+    prev = data;
+  }
+  Rms_sumQ15(&buf[start], lens - start, &pRms->Part.Sum, &pRms->Part.Pow);
+  pRms->Part.Num += lens - start;
+  pRms->Last = prev;
+
+  /* DC or too slow, report what there is */
+  if(pRms->Gate.Num + pRms->Part.Num >= pRms->GateNum * RMS_TIMEOUT) {
+    Rms_merge(&pRms->Gate, &pRms->Part);
+    Rms_publish(pRms, &pRms->Gate, 0);
+    Rms_clear(&pRms->Gate);
+    Rms_clear(&pRms->Part);
+    pRms->Periods = 0;
+    pRms->Sync = 0;
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Rms_Get
+**功能 : Get the Last Result
+**輸入 : *pRms, *pResult
+**輸出 : result count, 0 - none yet
+**使用 : if(Rms_Get(&rms, &result) != lastCount) { ... }
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t Rms_Get( Rms_Struct *pRms, RmsResult_Struct *pResult )
+{
+  uint32_t count = 0;
+
+  /* the block callback may publish while copying */
+  do {
+    count = pRms->Count;
+    *pResult = pRms->Result;
+  } while(count != pRms->Count);
+
+  return count;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Rms_sumQ15
+**功能 : Add Sum and Sum of Squares of q15 Samples, Two per Instruction
+**輸入 : *pSrc, lens, *pSum, *pPow
+**輸出 : None
+**使用 : Rms_sumQ15(buf, 32, &sum, &pow);
+**====================================================================================================*/
+/*====================================================================================================*/
+void Rms_sumQ15( const int16_t *pSrc, uint32_t lens, int32_t *pSum, int64_t *pPow )
+{
+  int64_t  pow = *pPow;
+  int32_t  sum = *pSum;
+  uint32_t in32 = 0;
+  uint32_t cnt = lens >> 1;
+
+  /* as arm_power_q15 / arm_mean_q15, but exact sums, segments of one gate add up without rounding */
+  while(cnt > 0) {
+    in32 = _SIMD32_OFFSET(pSrc);
+    pSrc += 2;
+    pow = (int64_t)__SMLALD(in32, in32, pow);
+    sum = (int32_t)__SMLAD(in32, 0x00010001, sum);
+    cnt--;
+  }
+  if(lens & 1) {
+    pow += (int32_t)*pSrc * *pSrc;
+    sum += *pSrc;
+  }
+
+  *pSum = sum;
+  *pPow = pow;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Rms_sqrtQ30
+**功能 : Integer Square Root, q30 Power to q15 Amplitude
+**輸入 : pow
+**輸出 : root
+**使用 : rms = Rms_sqrtQ30(pow);
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t Rms_sqrtQ30( uint32_t pow )
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while(bit > pow)
+    bit >>= 2;
+  while(bit != 0) {
+    if(pow >= root + bit) {
+      pow -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+
+  return (uint16_t)root;
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
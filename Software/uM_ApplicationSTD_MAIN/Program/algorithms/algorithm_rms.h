@@ -0,0 +1,56 @@
+/* #include "algorithm_rms.h" */
+
+#ifndef __ALGORITHM_RMS_H
+#define __ALGORITHM_RMS_H
+
+#include "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define RMS_BLOCK_MAX   64      // samples per Rms_Push()
+#define RMS_GATE_MAX    8192    // samples per result, RMS_TIMEOUT times this keeps Sum in 32 bits
+#define RMS_TIMEOUT     4       // gates without a crossing, then a result without period
+#define RMS_HYST_MIN    32      // q15, 4 ADC counts
+
+#define RMS_ADCtoQ15(__ADC) ((int16_t)(((int32_t)(__ADC) - 2048) << 3))   // 12-bit, mid scale 0
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  int64_t  Pow;         // sum of squares, q30
+  int32_t  Sum;         // q15
+  uint32_t Num;
+  int16_t  Max;
+  int16_t  Min;
+} RmsAcc_Struct;
+
+typedef struct {
+  int16_t  Mean;        // DC, q15
+  uint16_t Rms;         // AC part, DC removed, q15
+  uint16_t Peak;        // largest deviation from Mean, q15
+  uint32_t Period;      // samples per period, Q8, 0 - no crossing in time
+} RmsResult_Struct;
+
+typedef struct {
+  RmsAcc_Struct Gate;   // whole periods, first crossing to last crossing
+  RmsAcc_Struct Part;   // since the last crossing
+  uint32_t GateNum;     // samples per result, rounded up to whole periods
+  uint32_t GateFrac;    // crossing that opened the gate, Q8 sample
+  uint16_t Periods;
+  uint8_t  Sync;        // gate opened on a crossing
+  uint8_t  Armed;       // below Level - Hyst since the last crossing
+  int16_t  Level;       // crossing level, Mean of the last result
+  int16_t  Hyst;
+  int16_t  Last;        // last sample of the previous push
+  RmsResult_Struct Result;
+  __IO uint32_t Count;  // results so far
+} Rms_Struct;
+/*====================================================================================================*/
+/*====================================================================================================*/
+void     Rms_Init( Rms_Struct *pRms, uint32_t gateNum );
+void     Rms_Push( Rms_Struct *pRms, const uint16_t *pData, uint16_t lens, uint8_t stride );
+uint32_t Rms_Get( Rms_Struct *pRms, RmsResult_Struct *pResult );
+
+void     Rms_sumQ15( const int16_t *pSrc, uint32_t lens, int32_t *pSum, int64_t *pPow );
+uint16_t Rms_sqrtQ30( uint32_t pow );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -0,0 +1,139 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+
+#include "algorithm_trigger.h"
+
+#include "arm_math.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define TRIG_SIGN_PAIR  0x80008000    // sign bits of two halfwords
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Trig_Init
+**功能 : Rising Edge, Auto, Pre-trigger TRIG_PRE_DEF
+**輸入 : *pTrig, level, hyst
+**輸出 : None
+**使用 : Trig_Init(&trig, 2048, TRIG_HYST_DEF);
+**====================================================================================================*/
+/*====================================================================================================*/
+void Trig_Init( Trig_Struct *pTrig, uint16_t level, uint16_t hyst )
+{
+  pTrig->Edge    = TRIG_EDGE_RISE;
+  pTrig->Mode    = TRIG_MODE_AUTO;
+  pTrig->PreTrig = TRIG_PRE_DEF;
+  pTrig->State   = TRIG_STATE_WAIT;
+  pTrig->Armed   = 0;
+  pTrig->Hyst    = (hyst > TRIG_CODE_MAX / 4) ? TRIG_CODE_MAX / 4 : hyst;
+  Trig_setLevel(pTrig, level);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Trig_setLevel
+**功能 : Set Level, Kept a Hysteresis Band Away from Both Ends of the ADC Range
+**輸入 : *pTrig, level
+**輸出 : None
+**使用 : Trig_setLevel(&trig, trig.Level + 8);
+**====================================================================================================*/
+/*====================================================================================================*/
+void Trig_setLevel( Trig_Struct *pTrig, int32_t level )
+{
+  if(level < pTrig->Hyst)
+    level = pTrig->Hyst;
+  if(level > TRIG_CODE_MAX - pTrig->Hyst)
+    level = TRIG_CODE_MAX - pTrig->Hyst;
+  pTrig->Level = (uint16_t)level;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Trig_Arm
+**功能 : Leave HOLD and Forget a Half Seen Edge
+**輸入 : *pTrig
+**輸出 : None
+**使用 : Trig_Arm(&trig);  // next single shot
+**====================================================================================================*/
+/*====================================================================================================*/
+void Trig_Arm( Trig_Struct *pTrig )
+{
+  pTrig->Armed = 0;
+  pTrig->State = TRIG_STATE_WAIT;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Trig_Scan
+**功能 : Find the Next Edge, Arming State Carried over Calls
+**輸入 : *pTrig, *pData, lens
+**輸出 : index of the first sample on the far side of Level, TRIG_NONE - no edge
+**使用 : index = Trig_Scan(&trig, &ring[start], lens);  // contiguous samples, call again after a wrap
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t Trig_Scan( Trig_Struct *pTrig, const uint16_t *pData, uint32_t lens )
+{
+  uint8_t  rise = (pTrig->Edge == TRIG_EDGE_RISE);
+  uint32_t index = 0;
+  uint32_t found = 0;
+
+  /* rising: arm below Level - Hyst, fire at Level or above, falling mirrored */
+  if(!pTrig->Armed) {
+    found = rise ? Trig_find(pData, lens, pTrig->Level - pTrig->Hyst, 0)
+                 : Trig_find(pData, lens, pTrig->Level + pTrig->Hyst + 1, 1);
+    if(found == TRIG_NONE)
+      return TRIG_NONE;
+    pTrig->Armed = 1;
+    index = found;
+  }
+
+  found = rise ? Trig_find(&pData[index], lens - index, pTrig->Level, 1)
+               : Trig_find(&pData[index], lens - index, pTrig->Level + 1, 0);
+  if(found == TRIG_NONE)
+    return TRIG_NONE;
+  pTrig->Armed = 0;
+
+  return index + found;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Trig_find
+**功能 : First Sample at or above (or below) threshold, Eight Samples per Round
+**輸入 : *pData, lens, threshold, above
+**輸出 : index, TRIG_NONE - none
+**使用 : index = Trig_find(ring, 2048, 2048, 1);
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t Trig_find( const uint16_t *pData, uint32_t lens, uint16_t threshold, uint8_t above )
+{
+  uint32_t thr2 = __PKHBT(threshold, threshold, 16);
+  uint32_t d0, d1, d2, d3;
+  uint32_t i = 0;
+
+  /* 12-bit samples, SSUB16 leaves the sign bit set where a sample is below threshold */
+  if(above) {
+    for(; i + 8 <= lens; i += 8) {
+      d0 = __SSUB16(_SIMD32_OFFSET(&pData[i]),     thr2);
+      d1 = __SSUB16(_SIMD32_OFFSET(&pData[i + 2]), thr2);
+      d2 = __SSUB16(_SIMD32_OFFSET(&pData[i + 4]), thr2);
+      d3 = __SSUB16(_SIMD32_OFFSET(&pData[i + 6]), thr2);
+      if((d0 & d1 & d2 & d3 & TRIG_SIGN_PAIR) != TRIG_SIGN_PAIR)
+        break;
+    }
+  }
+  else {
+    for(; i + 8 <= lens; i += 8) {
+      d0 = __SSUB16(_SIMD32_OFFSET(&pData[i]),     thr2);
+      d1 = __SSUB16(_SIMD32_OFFSET(&pData[i + 2]), thr2);
+      d2 = __SSUB16(_SIMD32_OFFSET(&pData[i + 4]), thr2);
+      d3 = __SSUB16(_SIMD32_OFFSET(&pData[i + 6]), thr2);
+      if(((d0 | d1 | d2 | d3) & TRIG_SIGN_PAIR) != 0)
+        break;
+    }
+  }
+
+  /* the round with the hit and the tail, one at a time */
+  for(; i < lens; i++)
+    if((pData[i] >= threshold) == above)
+      return i;
+
+  return TRIG_NONE;
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
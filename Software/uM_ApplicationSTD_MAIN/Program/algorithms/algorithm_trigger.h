@@ -0,0 +1,52 @@
+/* #include "algorithm_trigger.h" */
+
+#ifndef __ALGORITHM_TRIGGER_H
+#define __ALGORITHM_TRIGGER_H
+
+#include "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define TRIG_NONE       0xFFFFFFFF
+#define TRIG_CODE_MAX   4095      // 12-bit ADC
+#define TRIG_HYST_DEF   16        // ADC codes, 0.4 % of full scale
+#define TRIG_PRE_DEF    50        // % of the window before the trigger
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef enum {
+  TRIG_EDGE_RISE = 0,
+  TRIG_EDGE_FALL,
+} Trig_Edge;
+
+typedef enum {
+  TRIG_MODE_AUTO = 0,   // no trigger in time, show the newest samples
+  TRIG_MODE_NORMAL,     // no trigger, keep the last frame
+  TRIG_MODE_SINGLE,     // one frame, then hold until Trig_Arm()
+  TRIG_MODE_MAX,
+} Trig_Mode;
+
+typedef enum {
+  TRIG_STATE_WAIT = 0,  // nothing new
+  TRIG_STATE_TRIG,      // new frame around a trigger
+  TRIG_STATE_AUTO,      // new frame, free running
+  TRIG_STATE_HOLD,      // single frame taken
+} Trig_State;
+
+typedef struct {
+  uint8_t  Edge;
+  uint8_t  Mode;
+  uint8_t  PreTrig;     // % of the window before the trigger
+  uint8_t  State;       // last result
+  uint8_t  Armed;       // crossed the hysteresis band on the far side of Level
+  uint16_t Level;       // ADC code
+  uint16_t Hyst;        // ADC code
+} Trig_Struct;
+/*====================================================================================================*/
+/*====================================================================================================*/
+void     Trig_Init( Trig_Struct *pTrig, uint16_t level, uint16_t hyst );
+void     Trig_setLevel( Trig_Struct *pTrig, int32_t level );
+void     Trig_Arm( Trig_Struct *pTrig );
+uint32_t Trig_Scan( Trig_Struct *pTrig, const uint16_t *pData, uint32_t lens );
+uint32_t Trig_find( const uint16_t *pData, uint32_t lens, uint16_t threshold, uint8_t above );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -15,48 +15,131 @@ void WaveFormInit( WaveForm_Struct *pWaveForm )
 }
 /*=====================================================================================================*/
 /*=====================================================================================================*/
-void WaveFormPrint( WaveForm_Struct *pWaveForm, uint8_t display )
+static uint16_t WavePic[WaveChannelMax][WaveFormW] = {0};
+static uint16_t WaveHead = 0;   // oldest column in WavePic
+
+#define WavePicAt(__CH, __COL)  WavePic[__CH][(WaveHead + (__COL)) % WaveFormW]
+
+static void WaveFormRedraw( WaveForm_Struct *pWaveForm )
 {
-  int16_t tmpY[WaveChannelMax] = {0};
-  int16_t posY[WaveChannelMax] = {0};
+  OLED_DrawRectFill(WaveWindowX, WaveWindowY, WaveFormW, WaveForm2H, pWaveForm->BackColor);
+  /* column i is drawn at x = i - 1, newest column next to the right frame */
+  for(int16_t i = 2; i < WaveFormW; i++)
+    for(int16_t j = 0; j < pWaveForm->Channel; j++)
+      if(WavePicAt(j, i))
+        OLED_DrawPixel(WaveWindowX + i - 1, WaveWindowY + WavePicAt(j, i), pWaveForm->PointColor[j]);
+  OLED_DrawRect(WaveWindowX, WaveWindowY, WaveFormW, WaveForm2H, pWaveForm->WindowColor);
+}
 
-  static uint16_t WavePic[WaveChannelMax][WaveFormW] = {0};
+static void WaveFormRoll( WaveForm_Struct *pWaveForm )
+{
+  int16_t posX = WaveWindowX + WaveFormW - 2;
+
+  /* shift trace one column left on OLED, frame columns excluded */
+  OLED_CopyRect(WaveWindowX + 2, WaveWindowY + 1, WaveFormW - 3, WaveForm2H - 1, WaveWindowX + 1, WaveWindowY + 1);
+  OLED_DrawLineY(posX, WaveWindowY + 1, WaveForm2H - 2, pWaveForm->BackColor);
+  for(int16_t j = 0; j < pWaveForm->Channel; j++)
+    if(WavePicAt(j, WaveFormW - 1))
+      OLED_DrawPixel(posX, WaveWindowY + WavePicAt(j, WaveFormW - 1), pWaveForm->PointColor[j]);
+  OLED_DrawPixel(posX, WaveWindowY + WaveForm2H - 1, pWaveForm->WindowColor);
+}
 
-  /* update position */
+void WaveFormPrint( WaveForm_Struct *pWaveForm, uint8_t display )
+{
+  int16_t tmpY = 0;
+  int16_t posY = 0;
+
+  /* update position, WavePic is a ring, newest column replaces oldest */
   for(int16_t i = 0; i < pWaveForm->Channel; i++) {
-    for(int16_t j = 0; j < WaveFormW - 1; j++)
-      WavePic[i][j] = WavePic[i][j + 1];
-    tmpY[i] = (int16_t)((float)pWaveForm->Data[i] / pWaveForm->Scale[i]);
-    posY[i] = WaveFormH - tmpY[i];
-    if((posY[i] > 0) && (posY[i] < WaveForm2H))
-      WavePic[i][WaveFormW - 1] = posY[i];
+    tmpY = (int16_t)((float)pWaveForm->Data[i] / pWaveForm->Scale[i]);
+    posY = WaveFormH - tmpY;
+    WavePic[i][WaveHead] = ((posY > 0) && (posY < WaveForm2H)) ? posY : 0;
+  }
+  WaveHead = (WaveHead + 1) % WaveFormW;
+
+  if(display != ENABLE) {
+    pWaveForm->Redraw = ENABLE;
+    return;
   }
-  if(display == ENABLE) {
-    /* display */
-    for(int16_t i = 0; i < WaveFormW - 1; i++) {
-      /* clean old data */
-      for(int16_t j = 0; j < pWaveForm->Channel; j++)
-        OLED_DrawPixel(WaveWindowX + i + 1, WaveWindowY + WavePic[j][i], pWaveForm->BackColor);
-//      /* plot line */
-//      if((i % 10) < 3) {
-//        for(int16_t j = 0; j <= pWaveFormH; j += (pWaveFormH / 10)) {
-//          OLED_DrawPixel(WaveWindowX + i, WaveWindowY + pWaveFormH + j, pWaveForm->WindowColor);
-//          OLED_DrawPixel(WaveWindowX + i, WaveWindowY + pWaveFormH - j, pWaveForm->WindowColor);
-//        }
-//      }
-//      /* plot mid line */
-//      OLED_DrawPixel(WaveWindowX + i, WaveWindowY + pWaveFormH, pWaveForm->WindowColor);
-      /* display new data */
-      for(int16_t j = 0; j < pWaveForm->Channel; j++)
-        OLED_DrawPixel(WaveWindowX + i, WaveWindowY + WavePic[j][i], pWaveForm->PointColor[j]);
+
+#if OLED_USE_COPY
+  if((pWaveForm->Roll == ENABLE) && (pWaveForm->Redraw != ENABLE)) {
+    WaveFormRoll(pWaveForm);
+    return;
+  }
+#endif
+  pWaveForm->Redraw = DISABLE;
+  WaveFormRedraw(pWaveForm);
+}
+
+void WaveFormPrintMark( WaveForm_Struct *pWaveForm, uint8_t channel, int16_t data, uint32_t color )
+{
+  int16_t posY = WaveFormH - (int16_t)((float)data / pWaveForm->Scale[channel]);
+
+  /* 2 x 3 tick inside the left frame, same scale as the trace, the old one is cleared first,
+     a level off the window sits on the nearest edge */
+  if(posY < 2)
+    posY = 2;
+  if(posY > WaveForm2H - 3)
+    posY = WaveForm2H - 3;
+  if(pWaveForm->Mark != 0)
+    OLED_DrawRectFill(WaveWindowX + 1, WaveWindowY + pWaveForm->Mark - 1, 2, 3, pWaveForm->BackColor);
+  pWaveForm->Mark = posY;
+  OLED_DrawRectFill(WaveWindowX + 1, WaveWindowY + pWaveForm->Mark - 1, 2, 3, color);
+}
+
+void WaveFormPrintBar( WaveForm_Struct *pWaveForm, const uint8_t *pBar, uint8_t mark )
+{
+  uint8_t height = 0;
+  int16_t posX = 0;
+
+  if(pWaveForm->Redraw == ENABLE) {
+    pWaveForm->Redraw = DISABLE;
+    OLED_DrawRectFill(WaveWindowX, WaveWindowY, WaveFormW, WaveForm2H, pWaveForm->BackColor);
+    OLED_DrawRect(WaveWindowX, WaveWindowY, WaveFormW, WaveForm2H, pWaveForm->WindowColor);
+  }
+
+  /* every column is rewritten, bar from the bottom, background above, no clear pass */
+  for(uint8_t i = 0; i < WaveBarW; i++) {
+    height = (pBar[i] < WaveBarH) ? pBar[i] : WaveBarH;
+    posX = WaveWindowX + 1 + i;
+    if(height < WaveBarH)
+      OLED_DrawLineY(posX, WaveWindowY + 1, WaveBarH - height, pWaveForm->BackColor);
+    if(height > 0)
+      OLED_DrawLineY(posX, WaveWindowY + 1 + WaveBarH - height, height, pWaveForm->PointColor[(i == mark) ? 1 : 0]);
+  }
+}
+
+void WaveFormPrintSpan( WaveForm_Struct *pWaveForm, uint8_t channel, const int16_t *pHigh, const int16_t *pLow )
+{
+  int16_t top = 0;
+  int16_t bottom = 0;
+  int16_t posX = 0;
+
+  if(pWaveForm->Redraw == ENABLE) {
+    pWaveForm->Redraw = DISABLE;
+    OLED_DrawRectFill(WaveWindowX, WaveWindowY, WaveFormW, WaveForm2H, pWaveForm->BackColor);
+    OLED_DrawRect(WaveWindowX, WaveWindowY, WaveFormW, WaveForm2H, pWaveForm->WindowColor);
+  }
+
+  /* every column is rewritten, background, max down to min, background, no clear pass */
+  for(uint8_t i = 0; i < WaveBarW; i++) {
+    top    = WaveFormH - (int16_t)((float)pHigh[i] / pWaveForm->Scale[channel]);
+    bottom = WaveFormH - (int16_t)((float)pLow[i] / pWaveForm->Scale[channel]);
+    posX   = WaveWindowX + 1 + i;
+    if((bottom < 1) || (top > WaveBarH)) {
+      OLED_DrawLineY(posX, WaveWindowY + 1, WaveBarH, pWaveForm->BackColor);
+      continue;
     }
-    for(int16_t j = 0; j < pWaveForm->Channel; j++)
-      OLED_DrawPixel(WaveWindowX, WaveWindowY + WavePic[j][0], pWaveForm->BackColor);
-    /* plot window line */
-    OLED_DrawLineX(WaveWindowX,                 WaveWindowY,                  WaveFormW,  pWaveForm->WindowColor);
-    OLED_DrawLineX(WaveWindowX,                 WaveWindowY + WaveForm2H - 1, WaveFormW,  pWaveForm->WindowColor);
-    OLED_DrawLineY(WaveWindowX,                 WaveWindowY,                  WaveForm2H, pWaveForm->WindowColor);
-    OLED_DrawLineY(WaveWindowX + WaveFormW - 1, WaveWindowY,                  WaveForm2H, pWaveForm->WindowColor);
+    if(top < 1)
+      top = 1;
+    if(bottom > WaveBarH)
+      bottom = WaveBarH;
+    if(top > 1)
+      OLED_DrawLineY(posX, WaveWindowY + 1, top - 1, pWaveForm->BackColor);
+    OLED_DrawLineY(posX, WaveWindowY + top, bottom - top + 1, pWaveForm->PointColor[channel]);
+    if(bottom < WaveBarH)
+      OLED_DrawLineY(posX, WaveWindowY + bottom + 1, WaveBarH - bottom, pWaveForm->BackColor);
   }
 }
 /*=====================================================================================================*/
@@ -12,6 +12,8 @@
 #define WaveFormW       96
 #define WaveFormH       24
 #define WaveForm2H      48
+#define WaveBarW        (WaveFormW - 2)   // inside the frame
+#define WaveBarH        (WaveForm2H - 2)
 /*=====================================================================================================*/
 /*=====================================================================================================*/
 typedef struct {
@@ -21,11 +23,17 @@ typedef struct {
   uint32_t PointColor[WaveChannelMax];
   uint32_t WindowColor;
   uint32_t BackColor;
+  uint8_t  Roll;      // ENABLE - shift trace on OLED and draw newest column only
+  uint8_t  Redraw;    // ENABLE - window was cleared, next print redraws all columns
+  uint8_t  Mark;      // row of the level mark, 0 - none
 } WaveForm_Struct;
 /*=====================================================================================================*/
 /*=====================================================================================================*/
 void WaveFormInit( WaveForm_Struct *pWaveForm );
 void WaveFormPrint( WaveForm_Struct *pWaveForm, uint8_t display );
+void WaveFormPrintBar( WaveForm_Struct *pWaveForm, const uint8_t *pBar, uint8_t mark );
+void WaveFormPrintSpan( WaveForm_Struct *pWaveForm, uint8_t channel, const int16_t *pHigh, const int16_t *pLow );
+void WaveFormPrintMark( WaveForm_Struct *pWaveForm, uint8_t channel, int16_t data, uint32_t color );
 /*=====================================================================================================*/
 /*=====================================================================================================*/
 #endif
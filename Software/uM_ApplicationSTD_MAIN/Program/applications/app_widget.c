@@ -0,0 +1,210 @@
+/*=====================================================================================================*/
+/*=====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+#include "modules\module_ssd1331.h"
+
+#include "app_widget.h"
+/*=====================================================================================================*/
+/*=====================================================================================================*/
+#define WIDGET_NONE     0
+#define WIDGET_GLYPH8   1
+#define WIDGET_GLYPH16  2
+#define WIDGET_GLYPH32  3
+#define WIDGET_RECT     4
+#define WIDGET_FILL     5
+#define WIDGET_BAR      6
+
+static WidgetCell_Struct WidgetCell[WidgetCellMax];
+static uint8_t WidgetNext = 0;
+/*=====================================================================================================*/
+/*=====================================================================================================*/
+static uint8_t WidgetRectHit( int16_t x1, int16_t y1, int16_t w1, int16_t h1, int16_t x2, int16_t y2, int16_t w2, int16_t h2 )
+{
+  return (x1 < x2 + w2) && (x2 < x1 + w1) && (y1 < y2 + h2) && (y2 < y1 + h1);
+}
+
+static uint8_t WidgetCellHit( const WidgetCell_Struct *pCell, uint8_t posX, uint8_t posY, uint8_t width, uint8_t height )
+{
+  /* an outline only owns its edges, glyphs inside a button frame don't touch it */
+  if(pCell->Kind == WIDGET_RECT)
+    return WidgetRectHit(pCell->PosX, pCell->PosY, pCell->Width, 1, posX, posY, width, height) ||
+           WidgetRectHit(pCell->PosX, pCell->PosY + pCell->Height - 1, pCell->Width, 1, posX, posY, width, height) ||
+           WidgetRectHit(pCell->PosX, pCell->PosY, 1, pCell->Height, posX, posY, width, height) ||
+           WidgetRectHit(pCell->PosX + pCell->Width - 1, pCell->PosY, 1, pCell->Height, posX, posY, width, height);
+
+  return WidgetRectHit(pCell->PosX, pCell->PosY, pCell->Width, pCell->Height, posX, posY, width, height);
+}
+
+static uint8_t WidgetCellOverlap( const WidgetCell_Struct *pCell, const WidgetCell_Struct *pNew )
+{
+  if(pNew->Kind == WIDGET_RECT)
+    return WidgetCellHit(pCell, pNew->PosX, pNew->PosY, pNew->Width, 1) ||
+           WidgetCellHit(pCell, pNew->PosX, pNew->PosY + pNew->Height - 1, pNew->Width, 1) ||
+           WidgetCellHit(pCell, pNew->PosX, pNew->PosY, 1, pNew->Height) ||
+           WidgetCellHit(pCell, pNew->PosX + pNew->Width - 1, pNew->PosY, 1, pNew->Height);
+
+  return WidgetCellHit(pCell, pNew->PosX, pNew->PosY, pNew->Width, pNew->Height);
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : WidgetUpdate
+**功能 : Check Cell against Screen, Forget Overlapped Cells
+**輸入 : pNew
+**輸出 : 1 - need draw, 0 - already on screen
+**使用 : if(WidgetUpdate(&cell)) OLED_PutChar16(...);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+static uint8_t WidgetUpdate( const WidgetCell_Struct *pNew )
+{
+  WidgetCell_Struct *pCell = NULL;
+  int16_t free = -1;
+
+  for(uint8_t i = 0; i < WidgetCellMax; i++) {
+    pCell = &WidgetCell[i];
+    if(pCell->Kind == WIDGET_NONE) {
+      if(free < 0) free = i;
+      continue;
+    }
+    if((pCell->Kind == pNew->Kind) && (pCell->PosX == pNew->PosX) && (pCell->PosY == pNew->PosY) &&
+       (pCell->Width == pNew->Width) && (pCell->Height == pNew->Height)) {
+      if((pCell->pWord == pNew->pWord) && (pCell->FontColor == pNew->FontColor) && (pCell->BackColor == pNew->BackColor))
+        return 0;
+      pCell->Kind = WIDGET_NONE;
+      if(free < 0) free = i;
+    }
+    else if(WidgetCellOverlap(pCell, pNew)) {
+      pCell->Kind = WIDGET_NONE;
+      if(free < 0) free = i;
+    }
+  }
+
+  /* table full, drop one, it will simply be drawn again next time */
+  if(free < 0) {
+    free = WidgetNext;
+    WidgetNext = (WidgetNext + 1) % WidgetCellMax;
+  }
+  WidgetCell[free] = *pNew;
+
+  return 1;
+}
+
+static uint8_t WidgetGlyph( uint8_t kind, uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const void *pWord, uint16_t fontColor, uint16_t backColor )
+{
+  WidgetCell_Struct cell;
+
+  cell.Kind      = kind;
+  cell.PosX      = posX;
+  cell.PosY      = posY;
+  cell.Width     = word_w;
+  cell.Height    = word_h;
+  cell.pWord     = pWord;
+  cell.FontColor = fontColor;
+  cell.BackColor = backColor;
+
+  return WidgetUpdate(&cell);
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : WidgetReset
+**功能 : Forget Everything on Screen
+**輸入 : None
+**輸出 : None
+**使用 : OLED_Clear(BLACK); WidgetReset();
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void WidgetReset( void )
+{
+  for(uint8_t i = 0; i < WidgetCellMax; i++)
+    WidgetCell[i].Kind = WIDGET_NONE;
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : WidgetInvalidate
+**功能 : Area was Drawn without Widget
+**輸入 : posX, posY, width, height
+**輸出 : None
+**使用 : WidgetInvalidate(0, 6, 96, 48);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void WidgetInvalidate( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height )
+{
+  for(uint8_t i = 0; i < WidgetCellMax; i++)
+    if((WidgetCell[i].Kind != WIDGET_NONE) && WidgetCellHit(&WidgetCell[i], posX, posY, width, height))
+      WidgetCell[i].Kind = WIDGET_NONE;
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : WidgetPutChar
+**功能 : Label / Digit Cell, Draw only if Glyph or Color Changed
+**輸入 : posX, posY, word_h, word_w, pWord, fontColor, backColor
+**輸出 : None
+**使用 : WidgetPutChar16(x, y, 22, 16, ASCII_NUM_22x16[n], WHITE, BLACK);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void WidgetPutChar( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint8_t *pWord, uint16_t fontColor, uint16_t backColor )
+{
+  if(WidgetGlyph(WIDGET_GLYPH8, posX, posY, word_h, word_w, pWord, fontColor, backColor))
+    OLED_PutChar(posX, posY, word_h, word_w, pWord, fontColor, backColor);
+}
+
+void WidgetPutChar16( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint16_t *pWord, uint16_t fontColor, uint16_t backColor )
+{
+  if(WidgetGlyph(WIDGET_GLYPH16, posX, posY, word_h, word_w, pWord, fontColor, backColor))
+    OLED_PutChar16(posX, posY, word_h, word_w, pWord, fontColor, backColor);
+}
+
+void WidgetPutChar32( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint32_t *pWord, uint16_t fontColor, uint16_t backColor )
+{
+  if(WidgetGlyph(WIDGET_GLYPH32, posX, posY, word_h, word_w, pWord, fontColor, backColor))
+    OLED_PutChar32(posX, posY, word_h, word_w, pWord, fontColor, backColor);
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : WidgetDrawRect
+**功能 : Frame / Fill Cell, Draw only if Changed
+**輸入 : posX, posY, width, height, color
+**輸出 : None
+**使用 : WidgetDrawRectFill(x, y, 2, 5, RED);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void WidgetDrawRect( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint16_t color )
+{
+  if(WidgetGlyph(WIDGET_RECT, posX, posY, height, width, NULL, color, color))
+    OLED_DrawRect(posX, posY, width, height, color);
+}
+
+void WidgetDrawRectFill( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint16_t color )
+{
+  if(WidgetGlyph(WIDGET_FILL, posX, posY, height, width, NULL, color, color))
+    OLED_DrawRectFill(posX, posY, width, height, color);
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : WidgetBar
+**功能 : Horizontal Bar Graph, Draw only the Changed Part
+**輸入 : pBar, value
+**輸出 : None
+**使用 : WidgetBar(&volBar, mV);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void WidgetBar( WidgetBar_Struct *pBar, uint32_t value )
+{
+  uint8_t length = (value >= pBar->FullScale) ? pBar->Width : (uint8_t)((uint64_t)value * pBar->Width / pBar->FullScale);
+  uint8_t posX = pBar->PosX;
+
+  /* bar cell lost (cleared / overdrawn), draw the whole bar again */
+  if(WidgetGlyph(WIDGET_BAR, pBar->PosX, pBar->PosY, pBar->Height, pBar->Width, NULL, pBar->BarColor, pBar->BackColor)) {
+    if(length > 0)
+      OLED_DrawRectFill(posX, pBar->PosY, length, pBar->Height, pBar->BarColor);
+    if(length < pBar->Width)
+      OLED_DrawRectFill(posX + length, pBar->PosY, pBar->Width - length, pBar->Height, pBar->BackColor);
+  }
+  else if(length > pBar->Length)
+    OLED_DrawRectFill(posX + pBar->Length, pBar->PosY, length - pBar->Length, pBar->Height, pBar->BarColor);
+  else if(length < pBar->Length)
+    OLED_DrawRectFill(posX + length, pBar->PosY, pBar->Length - length, pBar->Height, pBar->BackColor);
+
+  pBar->Length = length;
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*/
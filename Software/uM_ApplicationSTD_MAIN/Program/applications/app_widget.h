@@ -0,0 +1,46 @@
+/* #include "app_widget.h" */
+
+#ifndef __APP_WIDGET_H
+#define __APP_WIDGET_H
+
+#include "stm32f30x.h"
+/*=====================================================================================================*/
+/*=====================================================================================================*/
+#define WidgetCellMax   64
+/*=====================================================================================================*/
+/*=====================================================================================================*/
+typedef struct {
+  uint8_t  Kind;        // glyph 8/16/32, rect, fill, bar
+  uint8_t  PosX;
+  uint8_t  PosY;
+  uint8_t  Width;
+  uint8_t  Height;
+  const void *pWord;
+  uint16_t FontColor;
+  uint16_t BackColor;
+} WidgetCell_Struct;
+
+typedef struct {
+  uint8_t  PosX;
+  uint8_t  PosY;
+  uint8_t  Width;
+  uint8_t  Height;
+  uint32_t FullScale;
+  uint16_t BarColor;
+  uint16_t BackColor;
+  uint8_t  Length;      // on screen
+} WidgetBar_Struct;
+/*=====================================================================================================*/
+/*=====================================================================================================*/
+void    WidgetReset( void );
+void    WidgetInvalidate( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height );
+
+void    WidgetPutChar( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint8_t *pWord, uint16_t fontColor, uint16_t backColor );
+void    WidgetPutChar16( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint16_t *pWord, uint16_t fontColor, uint16_t backColor );
+void    WidgetPutChar32( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint32_t *pWord, uint16_t fontColor, uint16_t backColor );
+void    WidgetDrawRect( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint16_t color );
+void    WidgetDrawRectFill( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint16_t color );
+void    WidgetBar( WidgetBar_Struct *pBar, uint32_t value );
+/*=====================================================================================================*/
+/*=====================================================================================================*/
+#endif
@@ -15,11 +15,49 @@
 #define ADCxN_PIN               GPIO_Pin_2
 #define ADCxN_GPIO_PORT         GPIOA
 #define ADCxN_CHANNEL           ADC_Channel_3
+#define ADCxD_CHANNEL           ADC_Channel_3             // differential, IN3+ = PA2, IN4- = PA3
+
+#define ADCx_VREF_CHANNEL       ADC_Channel_Vrefint
+#define ADCx_TEMP_CHANNEL       ADC_Channel_TempSensor
+#define ADCx_INT_SAMPLE_TIME    ADC_SampleTime_181Cycles5   // VREFINT / temperature sensor need 2.2 us
+#define ADCx_INT_HALF_CYCLES    (363 + 25)
 
 #define ADCx_DMA_CHANNEL        DMA1_Channel1
+#define ADCx_DMA_IRQn           DMA1_Channel1_IRQn
+#define ADCx_DMA_IT_HT          DMA1_IT_HT1
+#define ADCx_DMA_IT_TC          DMA1_IT_TC1
 #define ADCx_DMA_CLK_ENABLE()   RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
 
-static __IO uint16_t ADC_DMA_ConvBuf[ADC_BUF_SIZE][ADC_BUF_CHENNAL] = {0};
+#define ADCx_CLOCK              (SystemCoreClock / 2)   // RCC_ADC12PLLCLK_Div2
+#define ADCx_TIM                TIM3
+#define ADCx_TIM_CLK_ENABLE()   RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE)
+#define ADCx_TIM_TRIG           ADC_ExternalTrigConvEvent_4   // TIM3_TRGO
+
+static __IO uint16_t ADC_DMA_ConvBuf[ADC_BUF_SIZE][ADC_BUF_CHENNAL] __attribute__((aligned(4))) = {0};  // CH1 + CH2, VREFINT + temperature, one SIMD word each
+static __IO uint32_t ADC_BlockCount = 0;  // completed halves
+static __IO uint8_t  ADC_BlockHalf = 0;   // half finished last, DMA is writing the other one
+static pADC_BlockFunc ADC_BlockCallback = NULL;
+static uint32_t ADC_SampleRate = 0;
+static uint16_t ADC_SampleHalfCycles = 0;   // sample + conversion, ADC clock / 2
+static __IO uint16_t ADC_JitterPeriod = 0;  // TIM period without jitter, 0 - jitter off
+static FunctionalState ADC_Differential = DISABLE;
+static uint16_t ADC_BurstLens = 1;          // ring length of ADC_startBurst()
+static uint16_t ADC_JitterSeed = 0xACE1;
+
+/* sample time in half cycles, a conversion adds 12.5 cycles */
+static const struct {
+  uint16_t halfCycles;
+  uint8_t  sampleTime;
+} ADC_SampleTimeTab[] = {
+  {   3, ADC_SampleTime_1Cycles5   },
+  {   5, ADC_SampleTime_2Cycles5   },
+  {   9, ADC_SampleTime_4Cycles5   },
+  {  15, ADC_SampleTime_7Cycles5   },
+  {  39, ADC_SampleTime_19Cycles5  },
+  { 123, ADC_SampleTime_61Cycles5  },
+  { 363, ADC_SampleTime_181Cycles5 },
+  {1203, ADC_SampleTime_601Cycles5 },
+};
 /*====================================================================================================*/
 /*====================================================================================================*
 **函數 : ADC_Config
@@ -29,19 +67,31 @@ static __IO uint16_t ADC_DMA_ConvBuf[ADC_BUF_SIZE][ADC_BUF_CHENNAL] = {0};
 **使用 : ADC_Config();
 **====================================================================================================*/
 /*====================================================================================================*/
-__IO uint16_t calibrationValue = 0;
+static __IO uint32_t calibrationValue = 0;   // ADC CALFACT, a zero CALFACT_S / CALFACT_D runs that self calibration
 
 void ADC_Config( void )
 {
   DMA_InitTypeDef DMA_InitStruct;
+  NVIC_InitTypeDef NVIC_InitStruct;
   ADC_InitTypeDef ADC_InitStruct;
   ADC_CommonInitTypeDef ADC_CommonInitStruct;
   GPIO_InitTypeDef GPIO_InitStruct;
+  TIM_TimeBaseInitTypeDef TIM_TimeBaseStruct;
 
   /* ADC Clk *******************************************************************/
   RCC_ADCCLKConfig(RCC_ADC12PLLCLK_Div2);
   ADCx_CLK_ENABLE();
   ADCx_DMA_CLK_ENABLE();
+  ADCx_TIM_CLK_ENABLE();
+
+  /* ADC Trigger TIM ***********************************************************/
+  TIM_TimeBaseStruct.TIM_Prescaler     = 0;
+  TIM_TimeBaseStruct.TIM_Period        = 0xFFFF;      // set by ADC_setSampleRate()
+  TIM_TimeBaseStruct.TIM_ClockDivision = TIM_CKD_DIV1;
+  TIM_TimeBaseStruct.TIM_CounterMode   = TIM_CounterMode_Up;
+  TIM_TimeBaseInit(ADCx_TIM, &TIM_TimeBaseStruct);
+  TIM_ARRPreloadConfig(ADCx_TIM, ENABLE);             // jitter writes ARR while running
+  TIM_SelectOutputTrigger(ADCx_TIM, TIM_TRGOSource_Update);
 
   /* ADC Pin *******************************************************************/
   GPIO_InitStruct.GPIO_Mode = GPIO_Mode_AN;
@@ -67,20 +117,36 @@ void ADC_Config( void )
   DMA_InitStruct.DMA_Priority           = DMA_Priority_Medium;
   DMA_InitStruct.DMA_M2M                = DMA_M2M_Disable;
   DMA_Init(ADCx_DMA_CHANNEL, &DMA_InitStruct);
-  DMA_Cmd(ADCx_DMA_CHANNEL, ENABLE);
+  DMA_ITConfig(ADCx_DMA_CHANNEL, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+  /* DMA NVIC ******************************************************************/
+  NVIC_InitStruct.NVIC_IRQChannel                   = ADCx_DMA_IRQn;
+  NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 0x0D;   // above the OLED DMA, a half must be taken before it is refilled
+  NVIC_InitStruct.NVIC_IRQChannelSubPriority        = 0;
+  NVIC_InitStruct.NVIC_IRQChannelCmd                = ENABLE;
+  NVIC_Init(&NVIC_InitStruct);
 
   /* ADC Calibration ***********************************************************/
   ADC_VoltageRegulatorCmd(ADCx, ENABLE);
-  delay_ms(10);
+  delay_us(10);   // regulator start up, 10 us
 
-  ADC_SelectCalibrationMode(ADCx, ADC_CalibrationMode_Single);
-  ADC_StartCalibration(ADCx);
+  if((calibrationValue & ADC_CALFACT_CALFACT_S) == 0) {
+    ADC_SelectCalibrationMode(ADCx, ADC_CalibrationMode_Single);
+    ADC_StartCalibration(ADCx);
 
-  while(ADC_GetCalibrationStatus(ADCx) != RESET);
-  calibrationValue = ADC_GetCalibrationValue(ADCx);
+    while(ADC_GetCalibrationStatus(ADCx) != RESET);
+    calibrationValue = (calibrationValue & ~ADC_CALFACT_CALFACT_S) | (ADC_GetCalibrationValue(ADCx) & ADC_CALFACT_CALFACT_S);
+  }
+  if((calibrationValue & ADC_CALFACT_CALFACT_D) == 0) {
+    ADC_SelectCalibrationMode(ADCx, ADC_CalibrationMode_Differential);
+    ADC_StartCalibration(ADCx);
+
+    while(ADC_GetCalibrationStatus(ADCx) != RESET);
+    calibrationValue = (calibrationValue & ~ADC_CALFACT_CALFACT_D) | (ADC_GetCalibrationValue(ADCx) & ADC_CALFACT_CALFACT_D);
+  }
 
   /* ADC Common Init ***********************************************************/
-  ADC_CommonInitStruct.ADC_Mode             = ADC_Mode_Interleave;             // ADC_Mode_Independent
+  ADC_CommonInitStruct.ADC_Mode             = ADC_Mode_Independent;            // PA2 / PA3 only reach ADC1, no dual modes
   ADC_CommonInitStruct.ADC_Clock            = ADC_Clock_AsynClkMode;
   ADC_CommonInitStruct.ADC_DMAAccessMode    = ADC_DMAAccessMode_1;
   ADC_CommonInitStruct.ADC_DMAMode          = ADC_DMAMode_Circular;
@@ -88,59 +154,411 @@ void ADC_Config( void )
   ADC_CommonInit(ADCx, &ADC_CommonInitStruct);
 
   /* ADC Init *****************************************************************/
-  ADC_InitStruct.ADC_ContinuousConvMode    = ADC_ContinuousConvMode_Enable;
+  ADC_InitStruct.ADC_ContinuousConvMode    = ADC_ContinuousConvMode_Disable;  // one sequence per TIM update
   ADC_InitStruct.ADC_Resolution            = ADC_Resolution_12b; 
-  ADC_InitStruct.ADC_ExternalTrigConvEvent = ADC_ExternalTrigConvEvent_0;         
-  ADC_InitStruct.ADC_ExternalTrigEventEdge = ADC_ExternalTrigEventEdge_None;
+  ADC_InitStruct.ADC_ExternalTrigConvEvent = ADCx_TIM_TRIG;
+  ADC_InitStruct.ADC_ExternalTrigEventEdge = ADC_ExternalTrigEventEdge_RisingEdge;
   ADC_InitStruct.ADC_DataAlign             = ADC_DataAlign_Right;
   ADC_InitStruct.ADC_OverrunMode           = ADC_OverrunMode_Disable;   
   ADC_InitStruct.ADC_AutoInjMode           = ADC_AutoInjec_Disable;  
-  ADC_InitStruct.ADC_NbrOfRegChannel       = ADC_BUF_SIZE;
+  ADC_InitStruct.ADC_NbrOfRegChannel       = ADC_BUF_CHENNAL;
   ADC_Init(ADCx, &ADC_InitStruct);
 
   /* ADC Regular Config *******************************************************/
   ADC_RegularChannelConfig(ADCx, ADCxP_CHANNEL, 1, ADC_SampleTime_601Cycles5);
   ADC_RegularChannelConfig(ADCx, ADCxN_CHANNEL, 2, ADC_SampleTime_601Cycles5);
+  ADC_RegularChannelConfig(ADCx, ADCx_VREF_CHANNEL, ADC_CH_VREFINT, ADCx_INT_SAMPLE_TIME);
+  ADC_RegularChannelConfig(ADCx, ADCx_TEMP_CHANNEL, ADC_CH_TEMP, ADCx_INT_SAMPLE_TIME);
+  ADC_VrefintCmd(ADCx, ENABLE);
+  ADC_TempSensorCmd(ADCx, ENABLE);
 
   /* Enable & Start ***********************************************************/
+  ADC_DMAConfig(ADCx, ADC_DMAMode_Circular);  // keep requesting DMA after the ring wraps
   ADC_DMACmd(ADCx, ENABLE);
   ADC_Cmd(ADCx, ENABLE);
   while(!ADC_GetFlagStatus(ADCx, ADC_FLAG_RDY));
+  ADC_SetCalibrationValue(ADCx, calibrationValue);  // stored factor, CALFACT is only writable while enabled
+  ADC_setSampleRate(ADC_SAMPLE_RATE_DEF);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_setCalibValue
+**功能 : Use a Stored Calibration Factor, Call before ADC_Config
+**輸入 : calibValue, 0 - self calibration in ADC_Config
+**輸出 : None
+**使用 : ADC_setCalibValue(record.AdcCalib);
+**====================================================================================================*/
+/*====================================================================================================*/
+void ADC_setCalibValue( uint32_t calibValue )
+{
+  calibrationValue = calibValue;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_getCalibValue
+**功能 : Get Calibration Factor in Use
+**輸入 : None
+**輸出 : calibValue
+**使用 : record.AdcCalib = ADC_getCalibValue();
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t ADC_getCalibValue( void )
+{
+  return calibrationValue;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_setSampleRate
+**功能 : Set TIM Trigger Rate and the Longest Sample Time that Fits
+**輸入 : sampleRate
+**輸出 : real sample rate
+**使用 : rate = ADC_setSampleRate(3200);  // 3.2 kHz, CH1 + CH2 per trigger
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t ADC_setSampleRate( uint32_t sampleRate )
+{
+  uint32_t ticks = 0;
+  uint32_t prescaler = 0;
+  uint32_t period = 0;
+  uint8_t  sampleTime = ADC_SampleTimeTab[0].sampleTime;
+  uint16_t halfCycles = ADC_SampleTimeTab[0].halfCycles;
+
+  if(sampleRate < ADC_SAMPLE_RATE_MIN) sampleRate = ADC_SAMPLE_RATE_MIN;
+  if(sampleRate > ADC_SAMPLE_RATE_MAX) sampleRate = ADC_SAMPLE_RATE_MAX;
+
+  ticks     = SystemCoreClock / sampleRate;
+  prescaler = (ticks - 1) / 0x10000;
+  period    = ticks / (prescaler + 1) - 1;
+
+  /* whole sequence within 3/4 of the trigger period, longest sample time wins (divider source is 1.7k) */
+  for(uint8_t i = 0; i < sizeof(ADC_SampleTimeTab) / sizeof(ADC_SampleTimeTab[0]); i++)
+    if((uint64_t)(ADC_PROBE_CHENNAL * (ADC_SampleTimeTab[i].halfCycles + 25) + (ADC_BUF_CHENNAL - ADC_PROBE_CHENNAL) * ADCx_INT_HALF_CYCLES) * sampleRate * 2 <= (uint64_t)ADCx_CLOCK * 3) {
+      sampleTime = ADC_SampleTimeTab[i].sampleTime;
+      halfCycles = ADC_SampleTimeTab[i].halfCycles;
+    }
+
+  /* stop, a new sample time can only be written while idle */
+  TIM_Cmd(ADCx_TIM, DISABLE);
+  if(ADC_GetStartConversionStatus(ADCx) != RESET) {
+    ADC_StopConversion(ADCx);
+    while(ADC_GetStartConversionStatus(ADCx) != RESET);
+  }
+
+  if(ADC_Differential == ENABLE) {
+    ADC_RegularChannelConfig(ADCx, ADCxD_CHANNEL, 1, sampleTime);   // IN4 must not be converted on its own now
+    ADC_RegularChannelConfig(ADCx, ADCxD_CHANNEL, 2, sampleTime);
+  }
+  else {
+    ADC_RegularChannelConfig(ADCx, ADCxP_CHANNEL, 1, sampleTime);
+    ADC_RegularChannelConfig(ADCx, ADCxN_CHANNEL, 2, sampleTime);
+  }
+
+  /* restart the ring at rank 1, a stop inside the sequence would swap channels */
+  DMA_Cmd(ADCx_DMA_CHANNEL, DISABLE);
+  DMA_SetCurrDataCounter(ADCx_DMA_CHANNEL, ADC_BUF_CHENNAL * ADC_BUF_SIZE);
   DMA_Cmd(ADCx_DMA_CHANNEL, ENABLE);
-  ADC_StartConversion(ADCx); 
+
+  ADCx_TIM->PSC = prescaler;
+  ADCx_TIM->ARR = period;
+  ADCx_TIM->EGR = TIM_EGR_UG;   // load PSC now, ADC is not armed yet so this TRGO is ignored
+  ADC_StartConversion(ADCx);  // armed, converts on the next TRGO
+  TIM_Cmd(ADCx_TIM, ENABLE);
+
+  ADC_SampleRate = SystemCoreClock / ((prescaler + 1) * (period + 1));
+  ADC_SampleHalfCycles = halfCycles + 25;
+  if(ADC_JitterPeriod)
+    ADC_JitterPeriod = period;
+
+  return ADC_SampleRate;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_getSampleRate
+**功能 : Get Real Sample Rate
+**輸入 : None
+**輸出 : sampleRate
+**使用 : rate = ADC_getSampleRate();
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t ADC_getSampleRate( void )
+{
+  return ADC_SampleRate;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_setJitter
+**功能 : Sampling Time Jitter, Random Trigger Period +-1/32 around the Set Sample Rate
+**輸入 : state
+**輸出 : None
+**使用 : ADC_setJitter(ENABLE);  // DC averaging only, the time axis is no longer uniform, no amplitude dither
+**====================================================================================================*/
+/*====================================================================================================*/
+void ADC_setJitter( FunctionalState state )
+{
+  uint16_t period = ADC_JitterPeriod;
+
+  if(state == ENABLE) {
+    if(period == 0)
+      ADC_JitterPeriod = ADCx_TIM->ARR;
+  }
+  else if(period != 0) {
+    ADC_JitterPeriod = 0;   // first, the DMA IRQ must not write ARR again
+    ADCx_TIM->ARR = period;
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_setDifferential
+**功能 : Convert PA2 - PA3 in Hardware Differential Mode, both Probe Ranks
+**輸入 : state
+**輸出 : None
+**使用 : ADC_setDifferential(ENABLE);  // ranks 1, 2 hold 2048 + (CH2 - CH1) * 2048 / VDDA
+**====================================================================================================*/
+/*====================================================================================================*/
+void ADC_setDifferential( FunctionalState state )
+{
+  if(state == ADC_Differential)
+    return;
+
+  /* DIFSEL is only writable while the ADC is disabled */
+  TIM_Cmd(ADCx_TIM, DISABLE);
+  if(ADC_GetStartConversionStatus(ADCx) != RESET) {
+    ADC_StopConversion(ADCx);
+    while(ADC_GetStartConversionStatus(ADCx) != RESET);
+  }
+  ADC_DisableCmd(ADCx);
+  while(ADC_GetDisableCmdStatus(ADCx) != RESET);
+
+  ADC_SelectDifferentialMode(ADCx, ADCxD_CHANNEL, state);
+  ADC_Differential = state;
+
+  ADC_Cmd(ADCx, ENABLE);
+  while(!ADC_GetFlagStatus(ADCx, ADC_FLAG_RDY));
+  ADC_SetCalibrationValue(ADCx, calibrationValue);  // CALFACT_D is applied to the differential channel
+  ADC_setSampleRate(ADC_SampleRate);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_getDifferential
+**功能 : Get Differential Mode State
+**輸入 : None
+**輸出 : state
+**使用 : if(ADC_getDifferential() == ENABLE) { ... }
+**====================================================================================================*/
+/*====================================================================================================*/
+FunctionalState ADC_getDifferential( void )
+{
+  return ADC_Differential;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_setBlockCallback
+**功能 : Set Function Called with Every Completed Half of the DMA Ring
+**輸入 : pCallback
+**輸出 : None
+**使用 : ADC_setBlockCallback(UM_PROBE_Block);  // runs in DMA IRQ, ADC_BLOCK_SIZE samples per channel
+**====================================================================================================*/
+/*====================================================================================================*/
+void ADC_setBlockCallback( pADC_BlockFunc pCallback )
+{
+  ADC_BlockCallback = pCallback;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_getChannelSkew
+**功能 : Get Delay from Rank 1 to Rank 2 as Part of the Sample Period
+**輸入 : None
+**輸出 : skew, Q16
+**使用 : skew = ADC_getChannelSkew();  // CH2 is sampled skew / 65536 periods after CH1
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t ADC_getChannelSkew( void )
+{
+  return (uint16_t)(((uint64_t)ADC_SampleHalfCycles * ADC_SampleRate << 15) / ADCx_CLOCK);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
+static void ADC_burstStart( uint8_t channel, uint16_t *pRing, uint16_t lens )
+{
+  /* stop the triggered ring */
+  TIM_Cmd(ADCx_TIM, DISABLE);
+  if(ADC_GetStartConversionStatus(ADCx) != RESET) {
+    ADC_StopConversion(ADCx);
+    while(ADC_GetStartConversionStatus(ADCx) != RESET);
+  }
+
+  /* circular DMA into pRing, polled, the block IRQ stays quiet */
+  DMA_Cmd(ADCx_DMA_CHANNEL, DISABLE);
+  DMA_ITConfig(ADCx_DMA_CHANNEL, DMA_IT_HT | DMA_IT_TC, DISABLE);
+  ADCx_DMA_CHANNEL->CMAR = (uint32_t)pRing;
+  DMA_SetCurrDataCounter(ADCx_DMA_CHANNEL, lens);
+  DMA_Cmd(ADCx_DMA_CHANNEL, ENABLE);
+  ADC_ClearFlag(ADCx, ADC_FLAG_OVR);  // an overrun blocks the DMA requests until cleared
+
+  /* single channel, continuous, shortest sample time, software start */
+  ADC_RegularChannelConfig(ADCx, (channel == 1) ? ADCxP_CHANNEL : ADCxN_CHANNEL, 1, ADC_SampleTime_1Cycles5);
+  ADC_RegularChannelSequencerLengthConfig(ADCx, 1);
+  ADCx->CFGR = (ADCx->CFGR & ~ADC_CFGR_EXTEN) | ADC_CFGR_CONT;
+  ADC_StartConversion(ADCx);
+}
+
+static void ADC_burstStop( void )
+{
+  ADC_StopConversion(ADCx);
+  while(ADC_GetStartConversionStatus(ADCx) != RESET);
+  ADC_ClearFlag(ADCx, ADC_FLAG_OVR);  // OVRMOD = 0, a set OVR would keep the TIM ring from refilling
+
+  /* back to the ring, ADC_setSampleRate() restores ranks, counter and TIM */
+  ADCx->CFGR = (ADCx->CFGR & ~ADC_CFGR_CONT) | ADC_ExternalTrigEventEdge_RisingEdge;
+  ADC_RegularChannelSequencerLengthConfig(ADCx, ADC_BUF_CHENNAL);
+  DMA_Cmd(ADCx_DMA_CHANNEL, DISABLE);
+  ADCx_DMA_CHANNEL->CMAR = (uint32_t)ADC_DMA_ConvBuf;
+  DMA_ClearITPendingBit(ADCx_DMA_IT_HT | ADCx_DMA_IT_TC);
+  DMA_ITConfig(ADCx_DMA_CHANNEL, DMA_IT_HT | DMA_IT_TC, ENABLE);
+  ADC_setSampleRate(ADC_SampleRate);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_startBurst
+**功能 : Convert One Channel Back to Back into a Circular Buffer until ADC_stopBurst()
+**輸入 : channel, *pRing, lens
+**輸出 : sample rate, 0 - fail
+**使用 : rate = ADC_startBurst(1, ring, 2048);  // the ring wraps every lens / rate seconds
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t ADC_startBurst( uint8_t channel, uint16_t *pRing, uint16_t lens )
+{
+  if((channel == 0) || (channel > ADC_PROBE_CHENNAL) || (lens == 0) || (ADC_Differential == ENABLE))
+    return 0;
+
+  ADC_BurstLens = lens;
+  ADC_burstStart(channel, pRing, lens);
+
+  return ADC_BURST_RATE;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_getBurstIndex
+**功能 : Get the Ring Index DMA Writes Next
+**輸入 : None
+**輸出 : index
+**使用 : index = ADC_getBurstIndex();  // poll at least once per wrap to count samples
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t ADC_getBurstIndex( void )
+{
+  uint16_t lens = ADCx_DMA_CHANNEL->CNDTR;
+
+  /* DMA fell behind and OVR stopped its requests, resume, the ring skips the lost samples */
+  if(ADC_GetFlagStatus(ADCx, ADC_FLAG_OVR) != RESET)
+    ADC_ClearFlag(ADCx, ADC_FLAG_OVR);
+
+  /* CNDTR counts down and reloads at 0 */
+  return (ADC_BurstLens - lens) % ADC_BurstLens;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_stopBurst
+**功能 : Stop the Circular Burst and Resume the Ring
+**輸入 : None
+**輸出 : None
+**使用 : ADC_stopBurst();
+**====================================================================================================*/
+/*====================================================================================================*/
+void ADC_stopBurst( void )
+{
+  ADC_burstStop();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_getBlock
+**功能 : Copy the Last Completed Block
+**輸入 : *pBlock
+**輸出 : block count, 0 - no block yet
+**使用 : count = ADC_getBlock(block[0]);  // uint16_t block[ADC_BLOCK_SIZE][ADC_BUF_CHENNAL]
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t ADC_getBlock( uint16_t *pBlock )
+{
+  const __IO uint16_t *pSrc = NULL;
+  uint32_t count = 0;
+
+  /* a new half means DMA has started on the one being copied, take the new one */
+  do {
+    count = ADC_BlockCount;
+    pSrc = ADC_DMA_ConvBuf[ADC_BlockHalf * ADC_BLOCK_SIZE];
+    for(uint16_t i = 0; i < ADC_BLOCK_SIZE * ADC_BUF_CHENNAL; i++)
+      pBlock[i] = pSrc[i];
+  } while(count != ADC_BlockCount);
+
+  return count;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : ADC_getBlockCount
+**功能 : Get Number of Completed Blocks
+**輸入 : None
+**輸出 : count
+**使用 : if(ADC_getBlockCount() != lastCount) { ... }
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t ADC_getBlockCount( void )
+{
+  return ADC_BlockCount;
 }
 /*====================================================================================================*/
 /*====================================================================================================*
 **函數 : ADC_getData
-**功能 : Get ADC Data
+**功能 : Get Newest Completed ADC Data
 **輸入 : channel
-**輸出 : None
-**使用 : ADC_ConvVal = ADC_getData();
+**輸出 : adcData
+**使用 : ADC_ConvVal = ADC_getData(1);
 **====================================================================================================*/
 /*====================================================================================================*/
 uint16_t ADC_getData( uint8_t channel )
 {
-  return (channel != 0) ? ADC_DMA_ConvBuf[0][channel - 1] : 0;
+  if((channel == 0) || (channel > ADC_BUF_CHENNAL))
+    return 0;
+
+  return ADC_DMA_ConvBuf[ADC_BlockHalf * ADC_BLOCK_SIZE + ADC_BLOCK_SIZE - 1][channel - 1];
 }
 /*====================================================================================================*/
+/*====================================================================================================*/
 /*====================================================================================================*
-**函數 : ADC_getAverage
-**功能 : Get Average
-**輸入 : *pADC_data, adcSample
+**函數 : ADC_DMA_IRQHandler
+**功能 : DMA Half / Full Transfer, a Block is Complete
+**輸入 : None
 **輸出 : None
-**使用 : ADC_getAverage(ADC_ConvVal, 64);
+**使用 : void DMA1_Channel1_IRQHandler( void ) { ADC_DMA_IRQHandler(); }
 **====================================================================================================*/
 /*====================================================================================================*/
-void ADC_getAverage( uint16_t *pADC_data, uint8_t adcSample )
+void ADC_DMA_IRQHandler( void )
 {
-  uint32_t tmpData = 0;
+  int8_t half = -1;
 
-  for(uint8_t i = 0; i < ADC_BUF_CHENNAL; i++) {
-    tmpData = 0;
-    for(uint8_t j = ADC_BUF_SIZE - adcSample; j < ADC_BUF_SIZE; j++)
-      tmpData += ADC_DMA_ConvBuf[j][i];
-    pADC_data[i] = (uint16_t)(tmpData / adcSample);
+  if(DMA_GetITStatus(ADCx_DMA_IT_HT) != RESET) {
+    DMA_ClearITPendingBit(ADCx_DMA_IT_HT);
+    half = 0;
+  }
+  if(DMA_GetITStatus(ADCx_DMA_IT_TC) != RESET) {
+    DMA_ClearITPendingBit(ADCx_DMA_IT_TC);
+    half = 1;
   }
+  if(half < 0)
+    return;
+
+  ADC_BlockHalf = half;
+  ADC_BlockCount++;
+
+  /* mains / PWM ripple no longer folds to a fixed alias and averages out,
+     the extra bits on a clean DC input still rest on the ADC's own noise */
+  if(ADC_JitterPeriod >= 32) {
+    ADC_JitterSeed = (ADC_JitterSeed >> 1) ^ (-(ADC_JitterSeed & 1) & 0xB400);
+    ADCx_TIM->ARR = ADC_JitterPeriod - (ADC_JitterPeriod >> 5) + (((uint32_t)ADC_JitterSeed * (ADC_JitterPeriod >> 4)) >> 16);
+  }
+
+  if(ADC_BlockCallback != NULL)
+    ADC_BlockCallback((const uint16_t *)ADC_DMA_ConvBuf[half * ADC_BLOCK_SIZE]);
 }
 /*====================================================================================================*/
 /*====================================================================================================*/
@@ -11,14 +11,40 @@
 #define ADC3_DR_ADDRESS   ((uint32_t)0x50000440)
 #define ADC4_DR_ADDRESS   ((uint32_t)0x50000540)
 
-#define ADC_BUF_CHENNAL   1
-#define ADC_BUF_SIZE      64
+#define ADC_BUF_CHENNAL   4                     // regular sequence, rank 1 - CH1, 2 - CH2, 3 - VREFINT, 4 - temperature
+#define ADC_PROBE_CHENNAL 2                     // CH1, CH2
+#define ADC_CH_VREFINT    3                     // channel number for ADC_getData() ...
+#define ADC_CH_TEMP       4
+#define ADC_BUF_SIZE      64                    // samples per channel in the DMA ring
+#define ADC_BLOCK_SIZE    (ADC_BUF_SIZE / 2)    // samples per channel in one completed half
+
+#define ADC_SAMPLE_RATE_DEF   10000             // Hz, CH1 + CH2 pairs, 601.5 cycles sample time
+#define ADC_SAMPLE_RATE_MIN   1
+#define ADC_SAMPLE_RATE_MAX   50000             // VREFINT and temperature need 181.5 cycles each
+
+#define ADC_BURST_RATE        (SystemCoreClock / 28)  // 1.5 + 12.5 cycles at PLL / 2, 2.57 Msps
+
+typedef void (*pADC_BlockFunc)( const uint16_t *pBlock );   // pBlock[ADC_BLOCK_SIZE][ADC_BUF_CHENNAL]
 /*====================================================================================================*/
 /*====================================================================================================*/
 void     ADC_Config( void );
+void     ADC_setCalibValue( uint32_t calibValue );
+uint32_t ADC_getCalibValue( void );
+void     ADC_setBlockCallback( pADC_BlockFunc pCallback );
+uint32_t ADC_setSampleRate( uint32_t sampleRate );
+uint32_t ADC_getSampleRate( void );
+void     ADC_setJitter( FunctionalState state );
+void     ADC_setDifferential( FunctionalState state );
+FunctionalState ADC_getDifferential( void );
+uint16_t ADC_getChannelSkew( void );
 
+uint32_t ADC_startBurst( uint8_t channel, uint16_t *pRing, uint16_t lens );
+uint16_t ADC_getBurstIndex( void );
+void     ADC_stopBurst( void );
+uint32_t ADC_getBlock( uint16_t *pBlock );
+uint32_t ADC_getBlockCount( void );
 uint16_t ADC_getData( uint8_t channel );
-void     ADC_getAverage( uint16_t *pADC_data, uint8_t adcSample );
+void     ADC_DMA_IRQHandler( void );
 /*====================================================================================================*/
 /*====================================================================================================*/
 #endif
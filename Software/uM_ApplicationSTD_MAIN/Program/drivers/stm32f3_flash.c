@@ -0,0 +1,57 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "stm32f3_system.h"
+#include "stm32f3_flash.h"
+
+#include <string.h>
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : FLASH_writePage
+**功能 : Erase a Page and Program Data from its Start
+**輸入 : pageAddr, *pData, lens (bytes, up to FLASH_PAGE_SIZE)
+**輸出 : SUCCESS / ERROR
+**使用 : state = FLASH_writePage(0x0801F800, &record, sizeof(record));
+**====================================================================================================*/
+/*====================================================================================================*/
+ErrorStatus FLASH_writePage( uint32_t pageAddr, const void *pData, uint32_t lens )
+{
+  const uint8_t *pByte = (const uint8_t *)pData;
+  FLASH_Status status = FLASH_COMPLETE;
+  uint16_t halfWord = 0;
+
+  if((pageAddr & (FLASH_PAGE_SIZE - 1)) || (lens > FLASH_PAGE_SIZE))
+    return ERROR;
+
+  /* the CPU stalls on the bus while the page is erased, about 40 ms */
+  FLASH_Unlock();
+  FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPERR);
+  status = FLASH_ErasePage(pageAddr);
+
+  for(uint32_t i = 0; (i < lens) && (status == FLASH_COMPLETE); i += 2) {
+    halfWord = pByte[i];
+    if(i + 1 < lens)
+      halfWord |= (uint16_t)pByte[i + 1] << 8;
+    status = FLASH_ProgramHalfWord(pageAddr + i, halfWord);
+  }
+  FLASH_Lock();
+
+  if(status != FLASH_COMPLETE)
+    return ERROR;
+
+  return (memcmp((const void *)pageAddr, pData, lens) == 0) ? SUCCESS : ERROR;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : FLASH_readData
+**功能 : Read Data
+**輸入 : addr, *pData, lens (bytes)
+**輸出 : None
+**使用 : FLASH_readData(0x0801F800, &record, sizeof(record));
+**====================================================================================================*/
+/*====================================================================================================*/
+void FLASH_readData( uint32_t addr, void *pData, uint32_t lens )
+{
+  memcpy(pData, (const void *)addr, lens);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
@@ -0,0 +1,16 @@
+/* #include "stm32f3_flash.h" */
+
+#ifndef __STM32F3_FLASH_H
+#define __STM32F3_FLASH_H
+
+#include "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define FLASH_PAGE_SIZE   ((uint32_t)0x00000800)  // 2 KB
+/*====================================================================================================*/
+/*====================================================================================================*/
+ErrorStatus FLASH_writePage( uint32_t pageAddr, const void *pData, uint32_t lens );
+void        FLASH_readData( uint32_t addr, void *pData, uint32_t lens );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -3,6 +3,16 @@
 #include "stm32f3_system.h"
 #include "stm32f3_spi.h"
 /*=====================================================================================================*/
+/*=====================================================================================================*/
+#define SPIx_DMA_TX_CHANNEL     DMA2_Channel2   // SPI3_TX
+#define SPIx_DMA_TX_IRQn        DMA2_Channel2_IRQn
+#define SPIx_DMA_TX_IT_TC       DMA2_IT_TC2
+#define SPIx_DMA_CLK_ENABLE()   RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA2, ENABLE)
+
+static SPI_TypeDef *SPI_DMA_SPIx = NULL;
+static pFunc SPI_DMA_Callback = NULL;
+static __IO uint8_t SPI_DMA_Busy = 0;
+/*=====================================================================================================*/
 /*=====================================================================================================*
 **函數 : SPI_RW8
 **功能 : Send and Receive Data
@@ -37,4 +47,175 @@ uint16_t SPI_RW( SPI_TypeDef *SPIx, uint16_t writeByte )
   return SPIx->DR;
 }
 /*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_Write8
+**功能 : Send Data without Waiting for Receive
+**輸入 : SPIx, writeByte
+**輸出 : None
+**使用 : SPI_Write8(SPI1, 0xFF);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void SPI_Write8( SPI_TypeDef *SPIx, uint8_t writeByte )
+{
+  while((SPIx->SR & SPI_I2S_FLAG_TXE) == (uint16_t)RESET);
+  *(__IO uint8_t *)(&SPIx->DR) = writeByte;
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_Write16
+**功能 : Send Data without Waiting for Receive
+**輸入 : SPIx, writeData
+**輸出 : None
+**使用 : SPI_Write16(SPI1, 0xFFFF);  // SPI_DataSize_16b
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void SPI_Write16( SPI_TypeDef *SPIx, uint16_t writeData )
+{
+  while((SPIx->SR & SPI_I2S_FLAG_TXE) == (uint16_t)RESET);
+  SPIx->DR = writeData;
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_WaitTx
+**功能 : Wait for Last Frame on the Wire, Drop Received Data
+**輸入 : SPIx
+**輸出 : None
+**使用 : SPI_WaitTx(SPI1);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void SPI_WaitTx( SPI_TypeDef *SPIx )
+{
+  while((SPIx->SR & SPI_SR_FTLVL) != SPI_TransmissionFIFOStatus_Empty);
+  while((SPIx->SR & SPI_I2S_FLAG_BSY) != (uint16_t)RESET);
+
+  /* drop the unread RX frames & clear overrun, SPI_RW8 relies on RXNE */
+  while((SPIx->SR & SPI_SR_FRLVL) != SPI_ReceptionFIFOStatus_Empty)
+    (void)*(__IO uint8_t *)(&SPIx->DR);
+  (void)SPIx->SR;
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_DMA_Config
+**功能 : SPI TX DMA Config
+**輸入 : SPIx
+**輸出 : None
+**使用 : SPI_DMA_Config(SPI3);
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void SPI_DMA_Config( SPI_TypeDef *SPIx )
+{
+  DMA_InitTypeDef DMA_InitStruct;
+  NVIC_InitTypeDef NVIC_InitStruct;
+
+  SPI_DMA_SPIx = SPIx;
+
+  /* DMA Clk *******************************************************************/
+  SPIx_DMA_CLK_ENABLE();
+
+  /* DMA Init ******************************************************************/
+  DMA_DeInit(SPIx_DMA_TX_CHANNEL);
+  DMA_InitStruct.DMA_PeripheralBaseAddr = (uint32_t)&SPIx->DR;
+  DMA_InitStruct.DMA_MemoryBaseAddr     = 0;
+  DMA_InitStruct.DMA_DIR                = DMA_DIR_PeripheralDST;
+  DMA_InitStruct.DMA_BufferSize         = 1;
+  DMA_InitStruct.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+  DMA_InitStruct.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+  DMA_InitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+  DMA_InitStruct.DMA_MemoryDataSize     = DMA_MemoryDataSize_HalfWord;
+  DMA_InitStruct.DMA_Mode               = DMA_Mode_Normal;
+  DMA_InitStruct.DMA_Priority           = DMA_Priority_High;
+  DMA_InitStruct.DMA_M2M                = DMA_M2M_Disable;
+  DMA_Init(SPIx_DMA_TX_CHANNEL, &DMA_InitStruct);
+  DMA_ITConfig(SPIx_DMA_TX_CHANNEL, DMA_IT_TC, ENABLE);
+
+  /* DMA NVIC ******************************************************************/
+  NVIC_InitStruct.NVIC_IRQChannel                   = SPIx_DMA_TX_IRQn;
+  NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 0x0E;
+  NVIC_InitStruct.NVIC_IRQChannelSubPriority        = 0;
+  NVIC_InitStruct.NVIC_IRQChannelCmd                = ENABLE;
+  NVIC_Init(&NVIC_InitStruct);
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_DMA_Send
+**功能 : Start a TX DMA Transfer
+**輸入 : pData, lens, memInc, pCallback
+**輸出 : None
+**使用 : SPI_DMA_Send(pBuf, 96, ENABLE, NULL);  // 96 half-words, callback in IRQ, keep it short
+**=====================================================================================================*/
+/*=====================================================================================================*/
+static void SPI_DMA_Start( const void *pData, uint16_t lens, FunctionalState memInc, uint32_t dataSize, pFunc pCallback )
+{
+  while(SPI_DMA_Busy);
+
+  SPI_DMA_Busy = 1;
+  SPI_DMA_Callback = pCallback;
+
+  SPIx_DMA_TX_CHANNEL->CCR &= ~(DMA_CCR_EN | DMA_CCR_MINC | DMA_CCR_PSIZE | DMA_CCR_MSIZE);
+  SPIx_DMA_TX_CHANNEL->CCR |= dataSize;
+  if(memInc == ENABLE)
+    SPIx_DMA_TX_CHANNEL->CCR |= DMA_CCR_MINC;
+  SPIx_DMA_TX_CHANNEL->CMAR  = (uint32_t)pData;
+  SPIx_DMA_TX_CHANNEL->CNDTR = lens;
+  SPIx_DMA_TX_CHANNEL->CCR  |= DMA_CCR_EN;
+
+  SPI_I2S_DMACmd(SPI_DMA_SPIx, SPI_I2S_DMAReq_Tx, ENABLE);
+}
+
+void SPI_DMA_Send( const void *pData, uint16_t lens, FunctionalState memInc, pFunc pCallback )
+{
+  SPI_DMA_Start(pData, lens, memInc, DMA_PeripheralDataSize_HalfWord | DMA_MemoryDataSize_HalfWord, pCallback);
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_DMA_Send8
+**功能 : Start a TX DMA Transfer, Byte Wide
+**輸入 : pData, lens, memInc, pCallback
+**輸出 : None
+**使用 : SPI_DMA_Send8(pBuf, 96, ENABLE, NULL);  // 96 bytes, SPI_DataSize_8b
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void SPI_DMA_Send8( const void *pData, uint16_t lens, FunctionalState memInc, pFunc pCallback )
+{
+  SPI_DMA_Start(pData, lens, memInc, DMA_PeripheralDataSize_Byte | DMA_MemoryDataSize_Byte, pCallback);
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_DMA_isBusy
+**功能 : Check TX DMA State
+**輸入 : None
+**輸出 : state
+**使用 : while(SPI_DMA_isBusy());
+**=====================================================================================================*/
+/*=====================================================================================================*/
+uint8_t SPI_DMA_isBusy( void )
+{
+  return SPI_DMA_Busy;
+}
+/*=====================================================================================================*/
+/*=====================================================================================================*
+**函數 : SPI_DMA_IRQHandler
+**功能 : TX DMA Transfer Complete
+**輸入 : None
+**輸出 : None
+**使用 : void DMA2_Channel2_IRQHandler( void ) { SPI_DMA_IRQHandler(); }
+**=====================================================================================================*/
+/*=====================================================================================================*/
+void SPI_DMA_IRQHandler( void )
+{
+  pFunc pCallback = SPI_DMA_Callback;
+
+  if(DMA_GetITStatus(SPIx_DMA_TX_IT_TC) != RESET) {
+    DMA_ClearITPendingBit(SPIx_DMA_TX_IT_TC);
+    SPIx_DMA_TX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    SPI_I2S_DMACmd(SPI_DMA_SPIx, SPI_I2S_DMAReq_Tx, DISABLE);
+
+    /* DMA is done when the FIFO is loaded, the caller runs SPI_WaitTx() at task level before CS goes high */
+    SPI_DMA_Callback = NULL;
+    SPI_DMA_Busy = 0;
+    if(pCallback != NULL)
+      pCallback();
+  }
+}
+/*=====================================================================================================*/
 /*=====================================================================================================*/
@@ -8,6 +8,15 @@
 /*=====================================================================================================*/
 uint8_t  SPI_RW8( SPI_TypeDef *SPIx, uint8_t writeByte );
 uint16_t SPI_RW( SPI_TypeDef *SPIx, uint16_t WriteByte );
+void     SPI_Write8( SPI_TypeDef *SPIx, uint8_t writeByte );
+void     SPI_Write16( SPI_TypeDef *SPIx, uint16_t writeData );
+void     SPI_WaitTx( SPI_TypeDef *SPIx );
+
+void     SPI_DMA_Config( SPI_TypeDef *SPIx );
+void     SPI_DMA_Send( const void *pData, uint16_t lens, FunctionalState memInc, pFunc pCallback );
+void     SPI_DMA_Send8( const void *pData, uint16_t lens, FunctionalState memInc, pFunc pCallback );
+uint8_t  SPI_DMA_isBusy( void );
+void     SPI_DMA_IRQHandler( void );
 /*=====================================================================================================*/
 /*=====================================================================================================*/
 #endif
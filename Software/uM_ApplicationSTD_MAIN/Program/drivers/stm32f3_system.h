@@ -11,6 +11,13 @@
 #define __GPIO_RST(_PORT, _PIN)   (_PORT->BSRR = (uint32_t)_PIN << 16)
 #define __GPIO_TOG(_PORT, _PIN)   (_PORT->ODR ^= _PIN)
 #define __GPIO_READ(_PORT, _PIN)  (_PORT->IDR  & _PIN)
+
+/* CCM SRAM, 8 KB, CPU only, never a DMA buffer, RW_IRAM2 in ProjectSTM32.sct */
+#if defined(__CC_ARM)
+#define __CCM_AT(_ADDR)  __attribute__((at(_ADDR), zero_init))
+#else
+#define __CCM_AT(_ADDR)
+#endif
 /*====================================================================================================*/
 /*====================================================================================================*/
 #define U8_MAX  ((uint8_t)255)
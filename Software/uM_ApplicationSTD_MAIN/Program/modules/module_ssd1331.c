@@ -5,6 +5,8 @@
 #include "algorithms\algorithm_string.h"
 
 #include "module_ssd1331.h"
+
+#include <string.h>
 /*====================================================================================================*/
 /*====================================================================================================*/
 #define OLED_SPIx                   SPI3
@@ -34,6 +36,55 @@
 #define OLED_SDI_GPIO_PORT          GPIOB
 #define OLED_SDI_AF                 GPIO_AF_6
 #define OLED_SDI_SOURCE             GPIO_PinSource5
+
+#define OLED_ACCEL_BASE_US          20    // command decode
+#define OLED_ACCEL_PIXEL_NS         500   // ~2 pixel/us, full screen fill in ~3 ms
+#define OLED_ACCEL_AREA_MIN         64    // smaller frame buffer fills go out as dirty pixels
+
+#define OLED_GLYPH_BUF_SIZE         (32 * 32)
+#define OLED_GLYPH_CACHE_MIN        64    // smaller glyphs unpack faster than a lookup, keep them out
+
+#if OLED_USE_HW_ACCEL
+static uint32_t OLED_AccelStart = 0;
+static uint32_t OLED_AccelCycles = 0;
+static uint8_t  OLED_AccelFillMode = 0xFF;
+#endif
+
+static uint8_t OLED_ColorMode = OLED_COLOR_65K;
+static uint8_t OLED_DataOpen = 0;   // DMA data left CS low, closed at task level
+
+#if OLED_GLYPH_CACHE_NUM
+typedef struct {
+  const void *pWord;
+  uint16_t FontColor;
+  uint16_t BackColor;
+  uint8_t  Width;
+  uint8_t  Height;
+  uint8_t  Mode;
+  uint32_t Used;    // LRU stamp, 0 - empty
+  uint16_t Pixel[OLED_GLYPH_CACHE_SIZE];  // RGB565, or packed RGB332 when drawing directly in 256 color
+} OLED_GlyphCache_Struct;
+
+static OLED_GlyphCache_Struct OLED_GlyphCache[OLED_GLYPH_CACHE_NUM];
+static uint32_t OLED_GlyphTick = 0;
+#endif
+
+#if OLED_USE_FRAMEBUFFER
+typedef struct {
+  uint8_t x1;
+  uint8_t y1;
+  uint8_t x2;
+  uint8_t y2;
+} OLED_Rect_Struct;
+
+static uint16_t OLED_FrameBuf[OLED_H][OLED_W] = {0};
+static OLED_Rect_Struct OLED_DirtyRect[OLED_DIRTY_RECT_NUM];
+static uint8_t OLED_DirtyNum = 0;
+
+static OLED_Rect_Struct OLED_FlushRect;
+static uint8_t OLED_FlushRow = 0;
+static uint8_t OLED_FlushLine[2][OLED_W];
+#endif
 /*====================================================================================================*/
 /*====================================================================================================*
 **函數 : SSD1331_Config
@@ -98,6 +149,52 @@ void SSD1331_Config( void )
 
   SPI_RxFIFOThresholdConfig(OLED_SPIx, SPI_RxFIFOThreshold_QF);
   SPI_Cmd(OLED_SPIx, ENABLE); 
+
+  /* SPI TX DMA **************************************************************/
+  SPI_DMA_Config(OLED_SPIx);
+
+  /* Cycle Counter for Busy Time & Benchmark *********************************/
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_WaitReady
+**功能 : Wait for DMA Transfer, then Close the Data Transfer it Left Open
+**輸入 : None
+**輸出 : None
+**使用 : OLED_WaitReady();
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_DataEnd( void );
+
+static void OLED_WaitReady( void )
+{
+  while(SPI_DMA_isBusy());
+  if(OLED_DataOpen) {
+    OLED_DataOpen = 0;
+    OLED_DataEnd();
+  }
+#if OLED_USE_HW_ACCEL
+  while((DWT->CYCCNT - OLED_AccelStart) < OLED_AccelCycles);
+  OLED_AccelCycles = 0;
+#endif
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_DataEnd
+**功能 : Wait for the Last Frame on the Wire, Deselect OLED, Back to 8-bit Frames
+**輸入 : None
+**輸出 : None
+**使用 : OLED_DataEnd();  // task level, OLED_WaitReady() for DMA data
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_DataEnd( void )
+{
+  SPI_WaitTx(OLED_SPIx);
+  SPI_DataSizeConfig(OLED_SPIx, SPI_DataSize_8b);
+  OLED_CS_H();
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -110,13 +207,64 @@ void SSD1331_Config( void )
 /*====================================================================================================*/
 static void OLED_WriteCmd( uint8_t writeCmd )
 {
+  OLED_WaitReady();
   OLED_CS_L();
   OLED_DC_L();
-  SPI_RW8(OLED_SPIx, writeCmd);
+  SPI_Write8(OLED_SPIx, writeCmd);
+  SPI_WaitTx(OLED_SPIx);
   OLED_CS_H();
 }
 /*====================================================================================================*/
 /*====================================================================================================*
+**函數 : OLED_WriteCmds
+**功能 : Write Command Sequence in One Transfer
+**輸入 : pCmd, lens
+**輸出 : None
+**使用 : OLED_WriteCmds(cmd, 3);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_WriteCmds( const uint8_t *pCmd, uint8_t lens )
+{
+  OLED_WaitReady();
+  OLED_CS_L();
+  OLED_DC_L();
+  for(uint8_t i = 0; i < lens; i++)
+    SPI_Write8(OLED_SPIx, pCmd[i]);
+  SPI_WaitTx(OLED_SPIx);
+  OLED_CS_H();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_DataStart
+**功能 : Select OLED for Pixel Data, 16-bit Frames for 65k, 8-bit for 256 Colors
+**輸入 : None
+**輸出 : None
+**使用 : OLED_DataStart();
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_DataStart( void )
+{
+  OLED_CS_L();
+  OLED_DC_H();
+  if(OLED_ColorMode == OLED_COLOR_65K)
+    SPI_DataSizeConfig(OLED_SPIx, SPI_DataSize_16b);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_PackRGB332
+**功能 : Convert RGB565 to RGB332, pDst may Alias pSrc
+**輸入 : pDst, pSrc, lens
+**輸出 : None
+**使用 : OLED_PackRGB332((uint8_t *)pBuf, pBuf, lens);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_PackRGB332( uint8_t *pDst, const uint16_t *pSrc, uint16_t lens )
+{
+  for(uint16_t i = 0; i < lens; i++)
+    pDst[i] = ToRGB332(pSrc[i]);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
 **函數 : OLED_WriteData
 **功能 : Write Data
 **輸入 : writeData
@@ -142,14 +290,294 @@ static void OLED_WriteCmd( uint8_t writeCmd )
 /*====================================================================================================*/
 static void OLED_WriteColor( uint16_t color )
 {
-  OLED_CS_L();
-  OLED_DC_H();
-  SPI_RW8(OLED_SPIx, Byte8H(color));
-  SPI_RW8(OLED_SPIx, Byte8L(color));
-  OLED_CS_H();
+  OLED_WaitReady();
+  OLED_DataStart();
+  if(OLED_ColorMode == OLED_COLOR_65K)
+    SPI_Write16(OLED_SPIx, color);
+  else
+    SPI_Write8(OLED_SPIx, ToRGB332(color));
+  OLED_DataEnd();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_WritePixels
+**功能 : Write Colors by CPU, 16-bit Frames Packed into TX FIFO
+**輸入 : pColor, lens
+**輸出 : None
+**使用 : OLED_WritePixels(lineBuf, OLED_W);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_WritePixels( const uint16_t *pColor, uint16_t lens )
+{
+  OLED_WaitReady();
+  OLED_DataStart();
+  if(OLED_ColorMode == OLED_COLOR_65K)
+    for(uint16_t i = 0; i < lens; i++)
+      SPI_Write16(OLED_SPIx, pColor[i]);
+  else
+    for(uint16_t i = 0; i < lens; i++)
+      SPI_Write8(OLED_SPIx, ToRGB332(pColor[i]));
+  OLED_DataEnd();
 }
 /*====================================================================================================*/
 /*====================================================================================================*
+**函數 : OLED_WriteFill
+**功能 : Write Same Color by DMA, Return Immediately
+**輸入 : color, lens
+**輸出 : None
+**使用 : OLED_WriteFill(BLACK, OLED_W * OLED_H);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_WriteFill( uint16_t color, uint16_t lens )
+{
+  static uint16_t fillColor = 0;
+
+  if(lens == 0)
+    return;
+
+  OLED_WaitReady();
+  OLED_DataStart();
+  OLED_DataOpen = 1;
+  if(OLED_ColorMode == OLED_COLOR_65K) {
+    fillColor = color;
+    SPI_DMA_Send(&fillColor, lens, DISABLE, NULL);
+  }
+  else {
+    fillColor = ToRGB332(color);
+    SPI_DMA_Send8(&fillColor, lens, DISABLE, NULL);
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_AccelRect
+**功能 : Graphic Acceleration Commands
+**輸入 : posX, posY, width, height, color, fill
+**輸出 : None
+**使用 : OLED_AccelRect(posX, posY, width, height, color, ENABLE);
+**====================================================================================================*/
+/*====================================================================================================*/
+#if OLED_USE_HW_ACCEL
+static void OLED_AccelBusy( uint32_t area )
+{
+  OLED_AccelStart  = DWT->CYCCNT;
+  OLED_AccelCycles = (SystemCoreClock / 1000000) * (OLED_ACCEL_BASE_US + area * OLED_ACCEL_PIXEL_NS / 1000);
+}
+
+static void OLED_AccelRect( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint16_t color, uint8_t fill )
+{
+  uint8_t cmd[13] = {0};
+  uint8_t lens = 0;
+
+  if((width == 0) || (height == 0))
+    return;
+
+  /* the panel drops 256 color data to RGB332, fill the same color next to flushed pixels */
+  if(OLED_ColorMode != OLED_COLOR_65K)
+    color = RGB332ToRGB565(ToRGB332(color));
+
+  if(OLED_AccelFillMode != fill) {
+    OLED_AccelFillMode = fill;
+    cmd[lens++] = 0x26;   // Fill Enable / Disable
+    cmd[lens++] = (fill == ENABLE) ? 0x01 : 0x00;
+  }
+
+  cmd[lens++] = 0x22;     // Draw Rectangle
+  cmd[lens++] = posX;
+  cmd[lens++] = posY;
+  cmd[lens++] = posX + width - 1;
+  cmd[lens++] = posY + height - 1;
+  for(uint8_t i = 0; i < 2; i++) {  // Outline, Fill
+    cmd[lens++] = RGB565_R(color) << 1;
+    cmd[lens++] = RGB565_G(color);
+    cmd[lens++] = RGB565_B(color) << 1;
+  }
+  OLED_WriteCmds(cmd, lens);
+  OLED_AccelBusy((fill == ENABLE) ? (width * height) : ((width + height) << 1));
+}
+
+static void OLED_AccelWindow( uint8_t cmd, uint8_t posX, uint8_t posY, uint8_t width, uint8_t height )
+{
+  uint8_t cmds[5] = { cmd, posX, posY, posX + width - 1, posY + height - 1 };  // 0x24 Dim Window, 0x25 Clear Window
+
+  if((width == 0) || (height == 0))
+    return;
+
+  OLED_WriteCmds(cmds, 5);
+  OLED_AccelBusy(width * height);
+}
+
+static void OLED_AccelCopy( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint8_t newPosX, uint8_t newPosY )
+{
+  uint8_t cmd[7] = { 0x23, posX, posY, posX + width - 1, posY + height - 1, newPosX, newPosY };  // Copy
+
+  if((width == 0) || (height == 0))
+    return;
+
+  OLED_WriteCmds(cmd, 7);
+  OLED_AccelBusy(width * height);
+}
+#endif
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_MarkDirty
+**功能 : Add Area to Dirty Rectangle List
+**輸入 : posX, posY, width, height
+**輸出 : None
+**使用 : OLED_MarkDirty(posX, posY, width, height);
+**====================================================================================================*/
+/*====================================================================================================*/
+#if OLED_USE_FRAMEBUFFER
+static int32_t OLED_RectArea( const OLED_Rect_Struct *pRect )
+{
+  return (int32_t)(pRect->x2 - pRect->x1 + 1) * (int32_t)(pRect->y2 - pRect->y1 + 1);
+}
+
+static void OLED_RectUnion( OLED_Rect_Struct *pRect, const OLED_Rect_Struct *pRectA, const OLED_Rect_Struct *pRectB )
+{
+  pRect->x1 = (pRectA->x1 < pRectB->x1) ? pRectA->x1 : pRectB->x1;
+  pRect->y1 = (pRectA->y1 < pRectB->y1) ? pRectA->y1 : pRectB->y1;
+  pRect->x2 = (pRectA->x2 > pRectB->x2) ? pRectA->x2 : pRectB->x2;
+  pRect->y2 = (pRectA->y2 > pRectB->y2) ? pRectA->y2 : pRectB->y2;
+}
+
+static void OLED_MarkDirty( int16_t posX, int16_t posY, int16_t width, int16_t height )
+{
+  OLED_Rect_Struct newRect, tmpRect;
+  int32_t extraArea = 0, minArea = S32_MAX;
+  int16_t posX2 = posX + width - 1;
+  int16_t posY2 = posY + height - 1;
+  uint8_t i = 0, minIndex = 0;
+
+  if(posX < 0)           posX  = 0;
+  if(posY < 0)           posY  = 0;
+  if(posX2 > OLED_W - 1) posX2 = OLED_W - 1;
+  if(posY2 > OLED_H - 1) posY2 = OLED_H - 1;
+  if((posX > posX2) || (posY > posY2))
+    return;
+
+  newRect.x1 = posX;
+  newRect.y1 = posY;
+  newRect.x2 = posX2;
+  newRect.y2 = posY2;
+
+  /* merge with rectangles that are cheaper to send together */
+  while(i < OLED_DirtyNum) {
+    OLED_RectUnion(&tmpRect, &newRect, &OLED_DirtyRect[i]);
+    extraArea = OLED_RectArea(&tmpRect) - OLED_RectArea(&newRect) - OLED_RectArea(&OLED_DirtyRect[i]);
+    if(extraArea <= OLED_DIRTY_MERGE_AREA) {
+      newRect = tmpRect;
+      OLED_DirtyRect[i] = OLED_DirtyRect[--OLED_DirtyNum];
+      i = 0;
+    }
+    else {
+      i++;
+    }
+  }
+
+  if(OLED_DirtyNum < OLED_DIRTY_RECT_NUM) {
+    OLED_DirtyRect[OLED_DirtyNum++] = newRect;
+    return;
+  }
+
+  /* list full, grow the rectangle that costs the least */
+  for(i = 0; i < OLED_DirtyNum; i++) {
+    OLED_RectUnion(&tmpRect, &newRect, &OLED_DirtyRect[i]);
+    extraArea = OLED_RectArea(&tmpRect) - OLED_RectArea(&OLED_DirtyRect[i]);
+    if(extraArea < minArea) {
+      minArea  = extraArea;
+      minIndex = i;
+    }
+  }
+  OLED_RectUnion(&OLED_DirtyRect[minIndex], &newRect, &OLED_DirtyRect[minIndex]);
+}
+#else
+static void OLED_MarkDirty( int16_t posX, int16_t posY, int16_t width, int16_t height )
+{
+  // draw to OLED directly, nothing to track
+}
+#endif
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_SetPixel
+**功能 : Set a Pixel without Dirty Tracking
+**輸入 : posX, posY, color
+**輸出 : None
+**使用 : OLED_SetPixel(posX, posY, color);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void OLED_SetPixel( uint16_t posX, uint16_t posY, uint16_t color )
+{
+#if OLED_USE_FRAMEBUFFER
+  if((posX < OLED_W) && (posY < OLED_H))
+    OLED_FrameBuf[posY][posX] = color;
+#else
+  OLED_DrawPixel(posX, posY, color);
+#endif
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_FillRect
+**功能 : Fill Rectangle in Frame Buffer, Large Areas Filled by the Panel
+**輸入 : posX, posY, width, height, color
+**輸出 : None
+**使用 : OLED_FillRect(posX, posY, width, height, color);
+**====================================================================================================*/
+/*====================================================================================================*/
+#if OLED_USE_FRAMEBUFFER
+#if OLED_USE_HW_ACCEL
+static ErrorStatus OLED_AccelFill( int16_t posX, int16_t posY, int16_t posX2, int16_t posY2, uint16_t color )
+{
+  OLED_Rect_Struct *pRect = NULL;
+  uint8_t i = 0;
+
+  if((posX2 - posX) * (posY2 - posY) < OLED_ACCEL_AREA_MIN)
+    return ERROR;
+
+  /* the panel takes the fill now, dirty pixels later, both from the same frame buffer */
+  while(i < OLED_DirtyNum) {
+    pRect = &OLED_DirtyRect[i];
+    if((pRect->x1 <= posX) && (pRect->y1 <= posY) && (pRect->x2 >= posX2 - 1) && (pRect->y2 >= posY2 - 1))
+      return SUCCESS;   // goes out with the flush anyway
+    if((pRect->x1 >= posX) && (pRect->y1 >= posY) && (pRect->x2 <= posX2 - 1) && (pRect->y2 <= posY2 - 1))
+      OLED_DirtyRect[i] = OLED_DirtyRect[--OLED_DirtyNum];
+    else
+      i++;
+  }
+
+  if(color == BLACK)
+    OLED_AccelWindow(0x25, posX, posY, posX2 - posX, posY2 - posY);
+  else
+    OLED_AccelRect(posX, posY, posX2 - posX, posY2 - posY, color, ENABLE);
+
+  return SUCCESS;
+}
+#endif
+
+static void OLED_FillRect( int16_t posX, int16_t posY, int16_t width, int16_t height, uint16_t color )
+{
+  int16_t posX2 = posX + width;
+  int16_t posY2 = posY + height;
+
+  if(posX < 0)       posX  = 0;
+  if(posY < 0)       posY  = 0;
+  if(posX2 > OLED_W) posX2 = OLED_W;
+  if(posY2 > OLED_H) posY2 = OLED_H;
+  if((posX >= posX2) || (posY >= posY2))
+    return;
+
+  for(int16_t i = posY; i < posY2; i++)
+    for(int16_t j = posX; j < posX2; j++)
+      OLED_FrameBuf[i][j] = color;
+
+#if OLED_USE_HW_ACCEL
+  if(OLED_AccelFill(posX, posY, posX2, posY2, color) == SUCCESS)
+    return;
+#endif
+  OLED_MarkDirty(posX, posY, posX2 - posX, posY2 - posY);
+}
+#endif
+/*====================================================================================================*/
+/*====================================================================================================*
 **函數 : SSD1331_Init
 **功能 : SSD1331 Init
 **輸入 : None
@@ -186,7 +614,7 @@ void SSD1331_Init( void )
   OLED_WriteCmd(0x64);   // 100
 
 	OLED_WriteCmd(0xA0);   // Set Remap & Color Depth
-	OLED_WriteCmd(0x72);   // 0x72
+	OLED_WriteCmd(OLED_ColorMode);   // 0x72
 
 	OLED_WriteCmd(0xA1);   // Set Display Start Line
 	OLED_WriteCmd(0x00);   // 0
@@ -221,6 +649,11 @@ void SSD1331_Init( void )
 
   OLED_Display(ENABLE);
   OLED_Clear(WHITE);
+
+#if OLED_TEST_SPI
+  OLED_TestSPI();
+  delay_ms(3000);   // read the rates before the menu draws over them
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -240,6 +673,93 @@ void OLED_Display( uint8_t onoff )
 }
 /*====================================================================================================*/
 /*====================================================================================================*
+**函數 : OLED_SetColorMode
+**功能 : Switch between 65k (RGB565) and 256 (RGB332) Colors, Drawing API Keeps RGB565
+**輸入 : mode
+**輸出 : None
+**使用 : OLED_SetColorMode(OLED_COLOR_256);
+**====================================================================================================*/
+/*====================================================================================================*/
+void OLED_SetColorMode( uint8_t mode )
+{
+  if(mode == OLED_ColorMode)
+    return;
+
+  OLED_WaitReady();
+  OLED_ColorMode = mode;
+  OLED_WriteCmd(0xA0);   // Set Remap & Color Depth
+  OLED_WriteCmd(mode);
+}
+
+uint8_t OLED_GetColorMode( void )
+{
+  return OLED_ColorMode;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_FlushNext
+**功能 : Send Next Row of the Rectangle in Flight, Chained from DMA IRQ
+**輸入 : None
+**輸出 : None
+**使用 : SPI_DMA_Send(pRow, width, ENABLE, OLED_FlushNext);
+**====================================================================================================*/
+/*====================================================================================================*/
+#if OLED_USE_FRAMEBUFFER
+static void OLED_FlushNext( void )
+{
+  /* IRQ context, only the next transfer, window & CS are left to OLED_Flush() */
+  if(OLED_FlushRow > OLED_FlushRect.y2)
+    return;
+
+  SPI_DMA_Send(&OLED_FrameBuf[OLED_FlushRow++][OLED_FlushRect.x1], OLED_FlushRect.x2 - OLED_FlushRect.x1 + 1, ENABLE, OLED_FlushNext);
+}
+#endif
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_Flush
+**功能 : Push Dirty Rectangles to OLED
+**輸入 : None
+**輸出 : None
+**使用 : OLED_Flush();  // returns with the last rectangle still on DMA
+**====================================================================================================*/
+/*====================================================================================================*/
+void OLED_Flush( void )
+{
+#if OLED_USE_FRAMEBUFFER
+  OLED_Rect_Struct *pRect = NULL;
+  uint16_t width = 0;
+
+  for(uint8_t i = 0; i < OLED_DirtyNum; i++) {
+    pRect = &OLED_DirtyRect[i];
+    width = pRect->x2 - pRect->x1 + 1;
+
+    /* waits for the rectangle before, the window commands stay out of the DMA IRQ */
+    OLED_SetWindow(pRect->x1, pRect->y1, pRect->x2, pRect->y2);
+    OLED_DataStart();
+    OLED_DataOpen = 1;
+
+    /* 256 colors, convert a row while the one before is on the wire */
+    if(OLED_ColorMode != OLED_COLOR_65K) {
+      for(uint8_t row = pRect->y1; row <= pRect->y2; row++) {
+        OLED_PackRGB332(OLED_FlushLine[row & 1], &OLED_FrameBuf[row][pRect->x1], width);
+        SPI_DMA_Send8(OLED_FlushLine[row & 1], width, ENABLE, NULL);
+      }
+    }
+    /* full width rows are contiguous in RAM, send them in one transfer */
+    else if(width == OLED_W) {
+      SPI_DMA_Send(&OLED_FrameBuf[pRect->y1][0], width * (pRect->y2 - pRect->y1 + 1), ENABLE, NULL);
+    }
+    else {
+      OLED_FlushRect = *pRect;
+      OLED_FlushRow  = pRect->y1 + 1;
+      SPI_DMA_Send(&OLED_FrameBuf[pRect->y1][pRect->x1], width, ENABLE, OLED_FlushNext);
+    }
+  }
+  OLED_DirtyNum = 0;
+#endif
+}
+/*====================================================================================================*/
+/*====================================================================================================*
 **函數 : OLED_Clear
 **功能 : Clear Window
 **輸入 : color
@@ -249,12 +769,19 @@ void OLED_Display( uint8_t onoff )
 /*====================================================================================================*/
 void OLED_Clear( uint16_t color )
 {
+#if OLED_USE_FRAMEBUFFER
+  OLED_FillRect(0, 0, OLED_W, OLED_H, color);
+#elif OLED_USE_HW_ACCEL
+  if(color == BLACK)
+    OLED_AccelWindow(0x25, 0, 0, OLED_W, OLED_H);
+  else
+    OLED_AccelRect(0, 0, OLED_W, OLED_H, color, ENABLE);
+#else
   uint32_t point = OLED_W * OLED_H;
 
   OLED_SetWindow(0, 0, OLED_W - 1, OLED_H - 1);
-
-  while(point--)
-    OLED_WriteColor(color);
+  OLED_WriteFill(color, point);
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -267,12 +794,9 @@ void OLED_Clear( uint16_t color )
 /*====================================================================================================*/
 void OLED_SetWindow( uint8_t posX1, uint8_t posY1, uint8_t posX2, uint8_t posY2 )
 {
-  OLED_WriteCmd(0x15);
-  OLED_WriteCmd(posX1);
-  OLED_WriteCmd(posX2);
-  OLED_WriteCmd(0x75);
-  OLED_WriteCmd(posY1);
-  OLED_WriteCmd(posY2);
+  uint8_t cmd[6] = { 0x15, posX1, posX2, 0x75, posY1, posY2 };
+
+  OLED_WriteCmds(cmd, 6);
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -285,8 +809,13 @@ void OLED_SetWindow( uint8_t posX1, uint8_t posY1, uint8_t posX2, uint8_t posY2
 /*====================================================================================================*/
 void OLED_DrawPixel( uint8_t posX, uint8_t posY, uint16_t color )
 {
+#if OLED_USE_FRAMEBUFFER
+  OLED_SetPixel(posX, posY, color);
+  OLED_MarkDirty(posX, posY, 1, 1);
+#else
   OLED_SetWindow(posX, posY, posX, posY);
   OLED_WriteColor(color);
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -299,14 +828,36 @@ void OLED_DrawPixel( uint8_t posX, uint8_t posY, uint16_t color )
 /*====================================================================================================*/
 void OLED_DrawLine( uint8_t posX1, uint8_t posY1, uint8_t posX2, uint8_t posY2, uint16_t color )
 {
+#if OLED_USE_FRAMEBUFFER
+  int16_t dx = (posX2 > posX1) ? (posX2 - posX1) : (posX1 - posX2);
+  int16_t dy = (posY2 > posY1) ? (posY1 - posY2) : (posY2 - posY1);
+  int16_t sx = (posX2 > posX1) ? 1 : -1;
+  int16_t sy = (posY2 > posY1) ? 1 : -1;
+  int16_t err = dx + dy, err2 = 0;
+  int16_t curX = posX1, curY = posY1;
+
+  while(1) {
+    OLED_SetPixel(curX, curY, color);
+    if((curX == posX2) && (curY == posY2))
+      break;
+    err2 = err << 1;
+    if(err2 >= dy) { err += dy; curX += sx; }
+    if(err2 <= dx) { err += dx; curY += sy; }
+  }
+  OLED_MarkDirty((posX1 < posX2) ? posX1 : posX2, (posY1 < posY2) ? posY1 : posY2, dx + 1, 1 - dy);
+#else
   OLED_WriteCmd(0x21);
   OLED_WriteCmd(posX1);
   OLED_WriteCmd(posY1);
   OLED_WriteCmd(posX2);
   OLED_WriteCmd(posY2);
-  OLED_WriteCmd(RGB565_R(color));
+  OLED_WriteCmd(RGB565_R(color) << 1);
   OLED_WriteCmd(RGB565_G(color));
-  OLED_WriteCmd(RGB565_B(color));
+  OLED_WriteCmd(RGB565_B(color) << 1);
+#if OLED_USE_HW_ACCEL
+  OLED_AccelBusy(((posX2 > posX1) ? (posX2 - posX1) : (posX1 - posX2)) + ((posY2 > posY1) ? (posY2 - posY1) : (posY1 - posY2)) + 1);
+#endif
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -319,10 +870,12 @@ void OLED_DrawLine( uint8_t posX1, uint8_t posY1, uint8_t posX2, uint8_t posY2,
 /*====================================================================================================*/
 void OLED_DrawLineX( uint8_t posX, uint8_t posY, uint8_t length, uint16_t color )
 {
+#if OLED_USE_FRAMEBUFFER
+  OLED_FillRect(posX, posY, length, 1, color);
+#else
   OLED_SetWindow(posX, posY, posX + length - 1, posY);
-
-  while(length--)
-    OLED_WriteColor(color);
+  OLED_WriteFill(color, length);
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -335,10 +888,12 @@ void OLED_DrawLineX( uint8_t posX, uint8_t posY, uint8_t length, uint16_t color
 /*====================================================================================================*/
 void OLED_DrawLineY( uint8_t posX, uint8_t posY, uint8_t length, uint16_t color )
 {
+#if OLED_USE_FRAMEBUFFER
+  OLED_FillRect(posX, posY, 1, length, color);
+#else
   OLED_SetWindow(posX, posY, posX, posY + length - 1);
-
-  while(length--)
-    OLED_WriteColor(color);
+  OLED_WriteFill(color, length);
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -351,10 +906,14 @@ void OLED_DrawLineY( uint8_t posX, uint8_t posY, uint8_t length, uint16_t color
 /*====================================================================================================*/
 void OLED_DrawRect( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint16_t color )
 {
+#if OLED_USE_HW_ACCEL && !OLED_USE_FRAMEBUFFER
+  OLED_AccelRect(posX, posY, width, height, color, DISABLE);
+#else
   OLED_DrawLineX(posX,             posY,              width,  color);
   OLED_DrawLineX(posX,             posY + height - 1, width,  color);
   OLED_DrawLineY(posX,             posY,              height, color);
   OLED_DrawLineY(posX + width - 1, posY,              height, color);
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -367,12 +926,85 @@ void OLED_DrawRect( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, u
 /*====================================================================================================*/
 void OLED_DrawRectFill( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint16_t color )
 {
+#if OLED_USE_FRAMEBUFFER
+  OLED_FillRect(posX, posY, width, height, color);
+#elif OLED_USE_HW_ACCEL
+  OLED_AccelRect(posX, posY, width, height, color, ENABLE);
+#else
   uint32_t point = width * height;
 
   OLED_SetWindow(posX, posY, posX + width - 1, posY + height - 1);
+  OLED_WriteFill(color, point);
+#endif
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_CopyRect
+**功能 : Copy Rectangle to New Position
+**輸入 : posX, posY, width, height, newPosX, newPosY
+**輸出 : None
+**使用 : OLED_CopyRect(1, 0, 95, 64, 0, 0);  // shift screen left
+**====================================================================================================*/
+/*====================================================================================================*/
+void OLED_CopyRect( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height, uint8_t newPosX, uint8_t newPosY )
+{
+#if OLED_USE_FRAMEBUFFER
+  int16_t stepY = (newPosY > posY) ? -1 : 1;
+  int16_t srcY  = (newPosY > posY) ? posY + height - 1 : posY;
+  int16_t dstY  = (newPosY > posY) ? newPosY + height - 1 : newPosY;
 
-  while(point--)
-    OLED_WriteColor(color);
+  if((posX + width > OLED_W) || (newPosX + width > OLED_W) || (posY + height > OLED_H) || (newPosY + height > OLED_H))
+    return;
+
+#if OLED_USE_HW_ACCEL
+  /* the panel copies its own pixels, they must be up to date before the frame buffer moves */
+  for(uint8_t i = 0; i < OLED_DirtyNum; i++) {
+    if((OLED_DirtyRect[i].x1 < posX + width) && (OLED_DirtyRect[i].x2 >= posX) &&
+       (OLED_DirtyRect[i].y1 < posY + height) && (OLED_DirtyRect[i].y2 >= posY)) {
+      OLED_Flush();
+      break;
+    }
+  }
+#endif
+
+  OLED_WaitReady();   // a 65k flush sends straight from the frame buffer
+  for(uint8_t i = 0; i < height; i++) {
+    memmove(&OLED_FrameBuf[dstY][newPosX], &OLED_FrameBuf[srcY][posX], width << 1);
+    srcY += stepY;
+    dstY += stepY;
+  }
+
+#if OLED_USE_HW_ACCEL
+  /* both sides moved the same pixels, nothing dirty */
+  OLED_AccelCopy(posX, posY, width, height, newPosX, newPosY);
+#else
+  OLED_MarkDirty(newPosX, newPosY, width, height);
+#endif
+#elif OLED_USE_HW_ACCEL
+  OLED_AccelCopy(posX, posY, width, height, newPosX, newPosY);
+#else
+  // no read back from OLED, nothing to copy
+#endif
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_DimRect
+**功能 : Dim Rectangle
+**輸入 : posX, posY, width, height
+**輸出 : None
+**使用 : OLED_DimRect(posX, posY, width, height);
+**====================================================================================================*/
+/*====================================================================================================*/
+void OLED_DimRect( uint8_t posX, uint8_t posY, uint8_t width, uint8_t height )
+{
+#if OLED_USE_FRAMEBUFFER
+  for(uint16_t i = posY; (i < posY + height) && (i < OLED_H); i++)
+    for(uint16_t j = posX; (j < posX + width) && (j < OLED_W); j++)
+      OLED_FrameBuf[i][j] = (OLED_FrameBuf[i][j] >> 1) & 0x7BEF;   // half of R, G, B
+  OLED_MarkDirty(posX, posY, width, height);
+#elif OLED_USE_HW_ACCEL
+  OLED_AccelWindow(0x24, posX, posY, width, height);
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -394,14 +1026,14 @@ void OLED_DrawCircle( uint8_t posX, uint8_t posY, uint8_t radius, uint16_t color
   curY = radius;
 
   while(curX <= curY) {
-    OLED_DrawPixel(posX + curX, posY - curY, color);
-    OLED_DrawPixel(posX - curX, posY - curY, color);
-    OLED_DrawPixel(posX + curY, posY - curX, color);
-    OLED_DrawPixel(posX - curY, posY - curX, color);
-    OLED_DrawPixel(posX + curX, posY + curY, color);
-    OLED_DrawPixel(posX - curX, posY + curY, color);
-    OLED_DrawPixel(posX + curY, posY + curX, color);
-    OLED_DrawPixel(posX - curY, posY + curX, color);
+    OLED_SetPixel(posX + curX, posY - curY, color);
+    OLED_SetPixel(posX - curX, posY - curY, color);
+    OLED_SetPixel(posX + curY, posY - curX, color);
+    OLED_SetPixel(posX - curY, posY - curX, color);
+    OLED_SetPixel(posX + curX, posY + curY, color);
+    OLED_SetPixel(posX - curX, posY + curY, color);
+    OLED_SetPixel(posX + curY, posY + curX, color);
+    OLED_SetPixel(posX - curY, posY + curX, color);
 
     if(D < 0) {
       D += (curX << 2) + 6;
@@ -412,6 +1044,134 @@ void OLED_DrawCircle( uint8_t posX, uint8_t posY, uint8_t radius, uint16_t color
     }
     curX++;
   }
+  OLED_MarkDirty(posX - radius, posY - radius, (radius << 1) + 1, (radius << 1) + 1);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_PutGlyph
+**功能 : Expand Glyph Rows to RGB565 and Write in One Window
+**輸入 : posX, posY, word_h, word_w, pWord, wordBits, cache, fontColor, backColor
+**輸出 : None
+**使用 : OLED_PutGlyph(posX, posY, 22, 16, ASCII_NUM_22x16[0], 16, ENABLE, WHITE, BLACK);
+**====================================================================================================*/
+/*====================================================================================================*/
+static uint32_t OLED_GlyphBits( const void *pWord, uint8_t wordBits, uint8_t row )
+{
+  switch(wordBits) {
+    case 8:   return ((const uint8_t *)pWord)[row];
+    case 16:  return ((const uint16_t *)pWord)[row];
+    default:  return ((const uint32_t *)pWord)[row];
+  }
+}
+
+static void OLED_GlyphRow( uint16_t *pPixel, uint32_t bits, uint8_t word_w, uint8_t width, uint16_t fontColor, uint16_t backColor )
+{
+  uint32_t mask = (uint32_t)0x01 << (word_w - 1);
+
+  for(uint8_t j = 0; j < width; j++, mask >>= 1)
+    pPixel[j] = (bits & mask) ? fontColor : backColor;
+}
+
+#if OLED_GLYPH_CACHE_NUM
+static const uint16_t *OLED_GlyphCached( const void *pWord, uint8_t wordBits, uint8_t word_h, uint8_t word_w, uint16_t fontColor, uint16_t backColor )
+{
+  OLED_GlyphCache_Struct *pEntry = NULL;
+  OLED_GlyphCache_Struct *pOld = &OLED_GlyphCache[0];
+
+  for(uint8_t i = 0; i < OLED_GLYPH_CACHE_NUM; i++) {
+    pEntry = &OLED_GlyphCache[i];
+    if((pEntry->pWord == pWord) && (pEntry->FontColor == fontColor) && (pEntry->BackColor == backColor) &&
+       (pEntry->Width == word_w) && (pEntry->Height == word_h) && (pEntry->Mode == OLED_ColorMode) && (pEntry->Used != 0)) {
+      pEntry->Used = ++OLED_GlyphTick;
+      return pEntry->Pixel;
+    }
+    if(pEntry->Used < pOld->Used)
+      pOld = pEntry;
+  }
+
+  /* miss, expand into the least recently used entry */
+  pEntry = pOld;
+#if !OLED_USE_FRAMEBUFFER
+  OLED_WaitReady();   // entry may still be read by DMA
+#endif
+  for(uint8_t i = 0; i < word_h; i++)
+    OLED_GlyphRow(&pEntry->Pixel[i * word_w], OLED_GlyphBits(pWord, wordBits, i), word_w, word_w, fontColor, backColor);
+#if !OLED_USE_FRAMEBUFFER
+  if(OLED_ColorMode != OLED_COLOR_65K)
+    OLED_PackRGB332((uint8_t *)pEntry->Pixel, pEntry->Pixel, word_h * word_w);
+#endif
+  pEntry->pWord     = pWord;
+  pEntry->FontColor = fontColor;
+  pEntry->BackColor = backColor;
+  pEntry->Width     = word_w;
+  pEntry->Height    = word_h;
+  pEntry->Mode      = OLED_ColorMode;
+  pEntry->Used      = ++OLED_GlyphTick;
+
+  return pEntry->Pixel;
+}
+#endif
+
+static void OLED_PutGlyph( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const void *pWord, uint8_t wordBits, uint8_t cache, uint16_t fontColor, uint16_t backColor )
+{
+  uint8_t width  = word_w;
+  uint8_t height = word_h;
+
+  if((posX >= OLED_W) || (posY >= OLED_H) || (width == 0) || (height == 0) || (word_w > 32))
+    return;
+  if(posX + width > OLED_W)   width  = OLED_W - posX;
+  if(posY + height > OLED_H)  height = OLED_H - posY;
+
+#if OLED_GLYPH_CACHE_NUM
+  /* whole glyph on screen and from a font table, blit the cached pixels as they are */
+  if(cache && (width == word_w) && (height == word_h) &&
+     (word_w * word_h >= OLED_GLYPH_CACHE_MIN) && (word_w * word_h <= OLED_GLYPH_CACHE_SIZE)) {
+    const uint16_t *pPixel = OLED_GlyphCached(pWord, wordBits, word_h, word_w, fontColor, backColor);
+#if OLED_USE_FRAMEBUFFER
+    for(uint8_t i = 0; i < height; i++)
+      memcpy(&OLED_FrameBuf[posY + i][posX], &pPixel[i * width], width << 1);
+    OLED_MarkDirty(posX, posY, width, height);
+#else
+    OLED_SetWindow(posX, posY, posX + width - 1, posY + height - 1);
+    OLED_DataStart();
+    OLED_DataOpen = 1;
+    if(OLED_ColorMode == OLED_COLOR_65K)
+      SPI_DMA_Send(pPixel, width * height, ENABLE, NULL);
+    else
+      SPI_DMA_Send8(pPixel, width * height, ENABLE, NULL);
+#endif
+    return;
+  }
+#else
+  (void)cache;
+#endif
+
+#if OLED_USE_FRAMEBUFFER
+  for(uint8_t i = 0; i < height; i++)
+    OLED_GlyphRow(&OLED_FrameBuf[posY + i][posX], OLED_GlyphBits(pWord, wordBits, i), word_w, width, fontColor, backColor);
+  OLED_MarkDirty(posX, posY, width, height);
+#else
+  static uint16_t glyphBuf[OLED_GLYPH_BUF_SIZE];
+  uint16_t band = OLED_GLYPH_BUF_SIZE / width;
+  uint8_t rows = 0;
+
+  /* glyphs up to 32x32 go out in a single window, larger ones in bands */
+  for(uint8_t row = 0; row < height; row += rows) {
+    rows = ((height - row) < band) ? (height - row) : band;
+    OLED_WaitReady();   // glyphBuf may still be read by DMA
+    for(uint8_t i = 0; i < rows; i++)
+      OLED_GlyphRow(&glyphBuf[i * width], OLED_GlyphBits(pWord, wordBits, row + i), word_w, width, fontColor, backColor);
+    OLED_SetWindow(posX, posY + row, posX + width - 1, posY + row + rows - 1);
+    OLED_DataStart();
+    OLED_DataOpen = 1;
+    if(OLED_ColorMode == OLED_COLOR_65K)
+      SPI_DMA_Send(glyphBuf, rows * width, ENABLE, NULL);
+    else {
+      OLED_PackRGB332((uint8_t *)glyphBuf, glyphBuf, rows * width);
+      SPI_DMA_Send8(glyphBuf, rows * width, ENABLE, NULL);
+    }
+  }
+#endif
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -424,17 +1184,7 @@ void OLED_DrawCircle( uint8_t posX, uint8_t posY, uint8_t radius, uint16_t color
 /*====================================================================================================*/
 void OLED_PutChar( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint8_t *pWord, uint16_t fontColor, uint16_t backColor )
 {
-  uint8_t tmp = 0;
-
-  for(uint8_t i = 0; i < word_h; i++) {
-    tmp = pWord[i];
-    for(uint8_t j = 0; j < word_w; j++) {
-      if(((tmp >> (word_w - 1 - j)) & 0x01) == 0x01)
-        OLED_DrawPixel(posX + j, posY + i, fontColor);
-      else
-        OLED_DrawPixel(posX + j, posY + i, backColor);
-    }
-  }
+  OLED_PutGlyph(posX, posY, word_h, word_w, pWord, 8, ENABLE, fontColor, backColor);
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -447,17 +1197,7 @@ void OLED_PutChar( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, c
 /*====================================================================================================*/
 void OLED_PutChar16( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint16_t *pWord, uint16_t fontColor, uint16_t backColor )
 {
-  uint16_t tmp = 0;
-
-  for(uint8_t i = 0; i < word_h; i++) {
-    tmp = pWord[i];
-    for(uint8_t j = 0; j < word_w; j++) {
-      if(((tmp >> (word_w - 1 - j)) & 0x0001) == 0x0001)
-        OLED_DrawPixel(posX + j, posY + i, fontColor);
-      else
-        OLED_DrawPixel(posX + j, posY + i, backColor);
-    }
-  }
+  OLED_PutGlyph(posX, posY, word_h, word_w, pWord, 16, ENABLE, fontColor, backColor);
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -470,17 +1210,7 @@ void OLED_PutChar16( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w,
 /*====================================================================================================*/
 void OLED_PutChar32( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w, const uint32_t *pWord, uint16_t fontColor, uint16_t backColor )
 {
-  uint32_t tmp = 0;
-
-  for(uint8_t i = 0; i < word_h; i++) {
-    tmp = pWord[i];
-    for(uint8_t j = 0; j < word_w; j++) {
-      if(((tmp >> (word_w - 1 - j)) & 0x00000001) == 0x00000001)
-        OLED_DrawPixel(posX + j, posY + i, fontColor);
-      else
-        OLED_DrawPixel(posX + j, posY + i, backColor);
-    }
-  }
+  OLED_PutGlyph(posX, posY, word_h, word_w, pWord, 32, ENABLE, fontColor, backColor);
 }
 
 //void OLED_PutCharNum_7x6( uint8_t CoordiX, uint8_t CoordiY, int8_t ChWord, uint16_t FontColor, uint16_t BackColor )
@@ -500,17 +1230,17 @@ void OLED_PutChar32( uint8_t posX, uint8_t posY, uint8_t word_h, uint8_t word_w,
 //}
 void OLED_PutChar_5x7( uint8_t posX, uint8_t posY, int8_t word, uint16_t fontColor, uint16_t backColor )
 {
+  uint8_t rows[7] = {0};
   uint8_t tmp = 0;
 
+  /* font is stored by column, bit r of column i is pixel (posX + i, posY + 1 + r) */
   for(uint8_t i = 0; i < 5; i++) {
     tmp = ASCII_NUM_5x7[word - 32][i];
-    for(uint8_t j = 0; j < 7; j++) {
-      if(((tmp >> (6 - j)) & 0x01) == 0x01)
-        OLED_DrawPixel(posX + i, posY + 7 - j, fontColor);
-      else
-        OLED_DrawPixel(posX + i, posY + 7 - j, backColor);
-    }
+    for(uint8_t r = 0; r < 7; r++)
+      if(((tmp >> r) & 0x01) == 0x01)
+        rows[r] |= 0x10 >> i;
   }
+  OLED_PutGlyph(posX, posY + 1, 7, 5, rows, 8, DISABLE, fontColor, backColor);  // rows is on the stack, never cache
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -646,8 +1376,60 @@ void OLED_TestFPS( void )
     GRAYBLUE
   };
 
-  for(uint8_t i = 0; i < COLOR_NUMBER; i++)
+  for(uint8_t i = 0; i < COLOR_NUMBER; i++) {
     OLED_Clear(drawColor[i]);
+    OLED_Flush();
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : OLED_TestSPI
+**功能 : SPI Throughput Benchmark, CPU & DMA against SCK Ceiling
+**輸入 : None
+**輸出 : None
+**使用 : OLED_TestSPI();
+**====================================================================================================*/
+/*====================================================================================================*/
+void OLED_TestSPI( void )
+{
+  static uint16_t lineBuf[OLED_W];
+  RCC_ClocksTypeDef RCC_Clocks;
+  uint32_t bytes = OLED_W * OLED_H * ((OLED_ColorMode == OLED_COLOR_65K) ? 2 : 1);
+  uint32_t tick = 0, clkSCK = 0, rateCPU = 0, rateDMA = 0;
+
+  RCC_GetClocksFreq(&RCC_Clocks);
+  clkSCK = RCC_Clocks.PCLK1_Frequency >> 1;   // SPI_BaudRatePrescaler_2
+
+  for(uint8_t i = 0; i < OLED_W; i++)
+    lineBuf[i] = RGB((i << 1), (i << 1), (0xFF - (i << 1)));
+
+  /* CPU, one line per call */
+  OLED_SetWindow(0, 0, OLED_W - 1, OLED_H - 1);
+  tick = DWT->CYCCNT;
+  for(uint8_t i = 0; i < OLED_H; i++)
+    OLED_WritePixels(lineBuf, OLED_W);
+  tick = DWT->CYCCNT - tick;
+  rateCPU = (uint32_t)((uint64_t)bytes * SystemCoreClock / tick);
+
+  /* DMA, whole screen in one transfer */
+  OLED_SetWindow(0, 0, OLED_W - 1, OLED_H - 1);
+  tick = DWT->CYCCNT;
+  OLED_WriteFill(GRAYBLUE, OLED_W * OLED_H);
+  OLED_WaitReady();
+  tick = DWT->CYCCNT - tick;
+  rateDMA = (uint32_t)((uint64_t)bytes * SystemCoreClock / tick);
+
+  /* result in kB/s and % of SCK / 8 */
+  OLED_Clear(BLACK);
+  OLED_PutStr_5x7(2,  2, "SCK", WHITE, BLACK);
+  OLED_PutNum(26,  2, Type_D, 5, clkSCK / 8000, WHITE, BLACK);
+  OLED_PutStr_5x7(2, 12, "CPU", WHITE, BLACK);
+  OLED_PutNum(26, 12, Type_D, 5, rateCPU / 1000, GREEN, BLACK);
+  OLED_PutNum(62, 12, Type_D, 3, (uint64_t)rateCPU * 800 / clkSCK, GREEN, BLACK);
+  OLED_PutStr_5x7(2, 22, "DMA", WHITE, BLACK);
+  OLED_PutNum(26, 22, Type_D, 5, rateDMA / 1000, CYAN, BLACK);
+  OLED_PutNum(62, 22, Type_D, 3, (uint64_t)rateDMA * 800 / clkSCK, CYAN, BLACK);
+  OLED_Flush();
 }
 /*====================================================================================================*/
 /*====================================================================================================*/
@@ -11,16 +11,36 @@
 #define OLED_W 96
 #define OLED_H 64
 
+#define OLED_USE_FRAMEBUFFER  1   // 1 - draw to RAM, push with OLED_Flush(), 0 - draw to OLED directly
+#define OLED_DIRTY_RECT_NUM   8   // max dirty rectangles per frame
+#define OLED_DIRTY_MERGE_AREA 8   // merge rectangles if union wastes <= 8 pixels (about one window setup)
+#define OLED_USE_HW_ACCEL     1   // 1 - use SSD1331 draw/copy/clear commands, for large fills & copies with the frame buffer
+#define OLED_USE_COPY         (OLED_USE_FRAMEBUFFER || OLED_USE_HW_ACCEL)   // OLED_CopyRect() available
+#define OLED_GLYPH_CACHE_NUM  4   // pre-expanded glyphs kept in SRAM (LRU), 0 - off, enough for a jittering last digit
+#define OLED_GLYPH_CACHE_SIZE (22 * 16)   // pixels per entry, 4 x 704 bytes for the 22x16 digits
+#define OLED_TEST_SPI         0   // 1 - show OLED_TestSPI() rates at the end of SSD1331_Init(), debug only
+
 #define RGB_TO_GARY(C_R, C_G, C_B)  ((uint8_t)(0.299f*C_R + 0.587f*C_G + 0.114f*C_B))
 #define ToRGB565(RGB888)            ((uint16_t)((RGB888&0xF80000>>8)|(RGB888&0x00FC00>>5)|(RGB888&0x0000F8>>3)))
 #define ToRGB888(RGB565)            ((uint16_t)((RGB565&0xF800<<8)|(RGB565&0x07E0<<5)|(RGB565&0x001F<<3)))
 
 #define RGB565_R(RGB565)            ((uint8_t)((RGB565 >> 11) & 0x1F))
-#define RGB565_G(RGB565)            ((uint8_t)((RGB565 >>  4) & 0x3F))
+#define RGB565_G(RGB565)            ((uint8_t)((RGB565 >>  5) & 0x3F))
 #define RGB565_B(RGB565)            ((uint8_t)((RGB565      ) & 0x1F))
 
+#define RGB332_R(RGB332)            ((uint8_t)((RGB332 >> 5) & 0x07))
+#define RGB332_G(RGB332)            ((uint8_t)((RGB332 >> 2) & 0x07))
+#define RGB332_B(RGB332)            ((uint8_t)((RGB332     ) & 0x03))
+#define ToRGB332(RGB565)            ((uint8_t)((((RGB565) >> 8) & 0xE0) | (((RGB565) >> 6) & 0x1C) | (((RGB565) >> 3) & 0x03)))
+#define RGB332ToRGB565(RGB332)      ((uint16_t)((((RGB332) & 0xE0) << 8) | (((RGB332) & 0x1C) << 6) | (((RGB332) & 0x03) << 3)))
+
+#define OLED_COLOR_65K              0x72    // remap & color depth, RGB565, 2 bytes per pixel
+#define OLED_COLOR_256              0x32    // remap & color depth, RGB332, 1 byte per pixel
+
 // 輸入 R G B，輸出 RGB565
 #define RGB(C_R, C_G, C_B)  ((uint32_t)(((C_R<<8)&0xF800)|((C_G<<3)&0x07E0)|((C_B>>3)&0x001F)))
+// 輸入 R G B，輸出 RGB332
+#define RGB8(C_R, C_G, C_B) ((uint8_t)(((C_R)&0xE0)|(((C_G)>>3)&0x1C)|(((C_B)>>6)&0x03)))
 
 #define RED         ((uint16_t)0xF800)  /* 紅色 */
 #define GREEN       ((uint16_t)0x07E0)  /* 綠色 */
@@ -49,6 +69,9 @@ void SSD1331_Config( void );
 void SSD1331_Init( void );
 
 void OLED_Display( uint8_t Cmd );
+void OLED_SetColorMode( uint8_t Mode );
+uint8_t OLED_GetColorMode( void );
+void OLED_Flush( void );
 void OLED_Clear( uint16_t Color );
 void OLED_SetWindow( uint8_t StartX, uint8_t StartY, uint8_t EndX, uint8_t EndY );
 void OLED_DrawPixel( uint8_t CoordiX, uint8_t CoordiY, uint16_t Color );
@@ -57,6 +80,8 @@ void OLED_DrawLineX( uint8_t CoordiX, uint8_t CoordiY, uint8_t Length, uint16_t
 void OLED_DrawLineY( uint8_t CoordiX, uint8_t CoordiY, uint8_t Length, uint16_t Color );
 void OLED_DrawRect( uint8_t CoordiX, uint8_t CoordiY, uint8_t Width, uint8_t Height, uint16_t Color );
 void OLED_DrawRectFill( uint8_t CoordiX, uint8_t CoordiY, uint8_t Width, uint8_t Height, uint16_t Color );
+void OLED_CopyRect( uint8_t CoordiX, uint8_t CoordiY, uint8_t Width, uint8_t Height, uint8_t NewCoordiX, uint8_t NewCoordiY );
+void OLED_DimRect( uint8_t CoordiX, uint8_t CoordiY, uint8_t Width, uint8_t Height );
 void OLED_DrawCircle( uint8_t CoordiX, uint8_t CoordiY, uint8_t Radius, uint16_t Color );
 void OLED_PutChar( uint8_t CoordiX, uint8_t CoordiY, uint8_t CharH, uint8_t CharW, const uint8_t *pMatrix, uint16_t FontColor, uint16_t BackColor );
 void OLED_PutChar16( uint8_t CoordiX, uint8_t CoordiY, uint8_t CharH, uint8_t CharW, const uint16_t *pMatrix, uint16_t FontColor, uint16_t BackColor );
@@ -66,6 +91,7 @@ void OLED_PutNum( uint8_t CoordiX, uint8_t CoordiY, StringType Type, uint8_t Len
 void OLED_PutNum_5x7( uint8_t CoordiX, uint8_t CoordiY, StringType Type, uint8_t Length, int32_t NumData, uint16_t FontColor, uint16_t BackColor );
 void OLED_TestColoBar( void );
 void OLED_TestFPS( void );
+void OLED_TestSPI( void );
 
 void OLED_PutStr_5x7( uint8_t CoordiX, uint8_t CoordiY, char *ChWord, uint16_t FontColor, uint16_t BackColor );
 void OLED_PutCharNum_7x6( uint8_t CoordiX, uint8_t CoordiY, int8_t ChWord, uint16_t FontColor, uint16_t BackColor );
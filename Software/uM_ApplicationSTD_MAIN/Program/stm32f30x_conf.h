@@ -39,7 +39,7 @@
 //#include "stm32f30x_dbgmcu.h"
 #include "stm32f30x_dma.h"
 //#include "stm32f30x_exti.h"
-//#include "stm32f30x_flash.h"
+#include "stm32f30x_flash.h"
 //#include "stm32f30x_fmc.h"
 #include "stm32f30x_gpio.h"
 //#include "stm32f30x_hrtim.h"
@@ -4,6 +4,10 @@
 #include "drivers\stm32f3_adc.h"
 #include "modules\module_buzzer.h"
 #include "algorithms\algorithm_mathUnit.h"
+#include "algorithms\algorithm_fft.h"
+#include "algorithms\algorithm_trigger.h"
+#include "algorithms\algorithm_measure.h"
+#include "algorithms\algorithm_rms.h"
 #include "applications\app_waveForm.h"
 
 #include "uMultimeter.h"
@@ -16,6 +20,45 @@ WaveForm_Struct WaveForm;
 
 #define DEFAULT_MODE MODE_VOL
 
+#define DMM_SAMPLE_RATE 10000   // Hz, VOL / RES
+#define AC_SAMPLE_RATE  ADC_SAMPLE_RATE_MAX   // Hz, VOL AC, 25 kHz signals, 5000 samples per result
+#define WAV_SAMPLE_RATE 3200    // Hz, ALL, one ADC block (32 samples) per column, 10 ms / column
+#define FFT_SAMPLE_RATE ADC_SAMPLE_RATE_MAX   // Hz, FFT, 0 - 25 kHz, 48.8 Hz per bin
+
+#define DMM_AVE_BITS    UM_PROBE_AVE_BITS   // 1024 samples, 102.4 ms window
+#define DMM_AVE_EMA     UM_PROBE_AVE_EMA
+#define DMM_OVS_BITS    4                   // VOL, 256 samples, 16-bit result, 0.43 mV
+#define WAV_AVE_BITS    5                   // 32 samples, one block per column
+#define WAV_AVE_EMA     0
+
+#define WAV_PEAK_DEPTH  (WaveBarW << PEAK_LEVEL_MAX)   // CH1 / CH2 scope, burst samples per frame, 292 us
+#define WAV_ZOOM_DEF    2       // 4 samples per column, 1.56 us / column
+#define WAV_TRIG_DEF    300     // mV, default level, 3 rows above the zero line, clear of the noise
+#define WAV_TRIG_FAST   10      // U / D repeats at one trace row, then 4 rows per step
+#define WAV_MEAS_PAGE   1500    // ms per measurement page in the header
+
+static UM_ProbePhase_Struct VolPhase;   // VOL AC, CH2 against CH1
+
+static uint32_t WaveBlockCount = 0;
+static uint8_t WaveZoom = WAV_ZOOM_DEF;   // PEAK_LEVEL_xxx, 2 ^ WaveZoom samples per column
+static uint8_t WaveFrame = DISABLE;       // ENABLE - columns to be rebuilt from WaveWork.Peak
+static int16_t WaveHigh[WaveBarW];
+static int16_t WaveLow[WaveBarW];
+static Trig_Struct WaveTrig;
+static uint8_t WaveTrigHold = 0;          // U / D repeats while held
+static Meas_Struct WaveMeas;
+static int32_t WaveMeasure[MEAS_WAV_NUM];
+
+#define WAV_FFT_SIZE    1024    // 20.5 ms capture at FFT_SAMPLE_RATE
+
+/* FFT and CH1 / CH2 never run together, FFT and peak cells share the CCM, the capture borrows the burst ring (DMA, SRAM) */
+static union {
+  Fft_Struct  Fft;
+  Peak_Struct Peak;
+} WaveWork __CCM_AT(CCMDATARAM_BASE);
+static uint16_t *WaveCapture = NULL;
+static uint16_t WaveColumn[WaveBarW];
+
 void UM_Run( void );
 /*====================================================================================================*/
 /*====================================================================================================*/
@@ -36,8 +79,12 @@ void UM_Init( void )
 	WaveForm.Scale[1]      = 100;
 	WaveForm.PointColor[0] = GREEN;
 	WaveForm.PointColor[1] = BLUE;
+	WaveForm.Roll          = ENABLE;
   WaveFormInit(&WaveForm);
+  Trig_Init(&WaveTrig, UM_PROBE_VolToADC(1, WAV_TRIG_DEF * 1000), TRIG_HYST_DEF);   // after the calibration is loaded
+  Meas_Init(&WaveMeas);
   OLED_Clear(BLACK);
+  OLED_Flush();
 }
 /*====================================================================================================*/
 /*====================================================================================================*/
@@ -53,6 +100,7 @@ void modeVOL_Init( uint32_t mode );
 void modeVOL_CH1( void );
 void modeVOL_CH2( void );
 void modeVOL_DIF( void );
+void modeVOL_AC( void );
 
 void modeRES_Init( uint32_t mode );
 void modeRES_RES( void );
@@ -66,6 +114,7 @@ void modeWAV_Init( uint32_t mode );
 void modeWAV_CH1( void );
 void modeWAV_CH2( void );
 void modeWAV_ALL( void );
+void modeWAV_FFT( void );
 void modeWAV_EXP( void );
 
 void modeEXP_Init( uint32_t mode );
@@ -75,6 +124,7 @@ struct menuItem_st itemVOL[MODE_VOL_MAX] = {
   {MODE_VOL_CH1, &modeVOL_CH1},
   {MODE_VOL_CH2, &modeVOL_CH2},
   {MODE_VOL_DIF, &modeVOL_DIF},
+  {MODE_VOL_AC,  &modeVOL_AC},
 };
 struct menuItem_st itemRES[MODE_RES_MAX] = {
   {MODE_RES_RES, &modeRES_RES},
@@ -88,6 +138,7 @@ struct menuItem_st itemWAV[MODE_WAV_MAX] = {
   {MODE_WAV_CH1, &modeWAV_CH1},
   {MODE_WAV_CH2, &modeWAV_CH2},
   {MODE_WAV_ALL, &modeWAV_ALL},
+  {MODE_WAV_FFT, &modeWAV_FFT},
   {MODE_WAV_EXP, &modeWAV_EXP},
 };
 struct menuItem_st itemEXP[MODE_EXP_MAX] = {
@@ -120,6 +171,11 @@ void modeVOL_Init( uint32_t mode )
 {
   UM_EXPAND_modeInit(MODE_VOL);
   UM_ProbeOCH_Cmd(ENABLE);
+  UM_ProbeICH_setSampleRate((mode == MODE_VOL_AC) ? AC_SAMPLE_RATE : DMM_SAMPLE_RATE);
+  UM_ProbeICH_setDifferential((mode == MODE_VOL_DIF) ? ENABLE : DISABLE);
+  UM_ProbeICH_setOverSample(DMM_OVS_BITS, (mode == MODE_VOL_AC) ? DISABLE : ENABLE);   // AC needs a uniform time axis
+  UM_ProbeICH_setRms((mode == MODE_VOL_AC) ? 1 : 0);
+  UM_ProbeICH_initPhase(&VolPhase);
   Buzzer_cmd(DISABLE);
 
   UM_EXPAND_modeVol(mode);
@@ -128,42 +184,58 @@ void modeVOL_Init( uint32_t mode )
 }
 void modeVOL_CH1( void )
 {
-  uint32_t tmpData = 0;
-  uint16_t readData[2] = {0};
-
-  readData[0] = UM_ProbeICH_getAveADC(1);
-  readData[1] = UM_ProbeICH_getAveADC(2);
-  tmpData = UM_PROBE_ADCtoVol(readData[0]);
-  UM_UI_modeVOL(readData[0], readData[1], tmpData);
+  int32_t  tmpData = 0;
+  uint32_t readData[2] = {0};
+  uint8_t  bits = UM_ProbeICH_getOverBits();
+
+  readData[0] = UM_ProbeICH_getOverADC(1);
+  readData[1] = UM_ProbeICH_getOverADC(2);
+  tmpData = UM_PROBE_ADCtoVol(1, readData[0], bits);
+  UM_UI_modeVOL(readData[0], readData[1], (tmpData > 0) ? tmpData : 0, bits);
+  UM_UI_modeVOL_putStatus(UM_ProbeICH_getVdda(), UM_ProbeICH_getTemp());
 }
 void modeVOL_CH2( void )
 {
-  uint32_t tmpData = 0;
-  uint16_t readData[2] = {0};
-
-  readData[0] = UM_ProbeICH_getAveADC(1);
-  readData[1] = UM_ProbeICH_getAveADC(2);
-  tmpData = UM_PROBE_ADCtoVol(readData[1]);
-  UM_UI_modeVOL(readData[0], readData[1], tmpData);
+  int32_t  tmpData = 0;
+  uint32_t readData[2] = {0};
+  uint8_t  bits = UM_ProbeICH_getOverBits();
+
+  readData[0] = UM_ProbeICH_getOverADC(1);
+  readData[1] = UM_ProbeICH_getOverADC(2);
+  tmpData = UM_PROBE_ADCtoVol(2, readData[1], bits);
+  UM_UI_modeVOL(readData[0], readData[1], (tmpData > 0) ? tmpData : 0, bits);
+  UM_UI_modeVOL_putStatus(UM_ProbeICH_getVdda(), UM_ProbeICH_getTemp());
 }
 void modeVOL_DIF( void )
 {
-  uint32_t tmpData = 0;
-  uint16_t readData[2] = {0};
+  int32_t  tmpData = 0;
+  uint32_t readData = UM_ProbeICH_getDifADC();
+  uint8_t  bits = UM_ProbeICH_getOverBits();
+
+  /* one differential conversion per reading, both ranks, no CH1 / CH2 skew */
+  tmpData = UM_PROBE_ADCtoVol(UM_PROBE_CH_DIF, readData, bits);
+  UM_UI_modeVOL(readData, readData, tmpData, bits);
+  UM_UI_modeVOL_putStatus(UM_ProbeICH_getVdda(), UM_ProbeICH_getTemp());
+}
+void modeVOL_AC( void )
+{
+  UM_ProbeAC_Struct ac;
 
-  readData[0] = UM_ProbeICH_getAveADC(1);
-  readData[1] = UM_ProbeICH_getAveADC(2);
-  if(readData[0] > readData[1])
-    tmpData = UM_PROBE_ADCtoVol(readData[0] - readData[1]);
-  else
-    tmpData = UM_PROBE_ADCtoVol(readData[1] - readData[0]);
-  UM_UI_modeVOL(readData[0], readData[1], tmpData);
+  /* all of the work is done per DMA block, this only reads the last result */
+  UM_ProbeICH_getAC(&ac);
+  UM_ProbeICH_getPhase(&VolPhase);
+  UM_UI_modeVOL((ac.Freq + 500) / 1000, ac.Crest, ac.Rms, UM_PROBE_RMS_BITS);
+  UM_UI_modeVOL_putPhase(UM_ProbeICH_getVdda(), VolPhase.Phase);
 }
 
 void modeRES_Init( uint32_t mode )
 {
   UM_EXPAND_modeInit(MODE_RES);
   UM_ProbeOCH_Cmd(ENABLE);
+  UM_ProbeICH_setSampleRate(DMM_SAMPLE_RATE);
+  UM_ProbeICH_setDifferential(DISABLE);
+  UM_ProbeICH_setRms(0);
+  UM_ProbeICH_setAverage(DMM_AVE_BITS, DMM_AVE_EMA);
   Buzzer_cmd(ENABLE);
 
   UM_UI_modeRES_Init(mode);
@@ -188,7 +260,7 @@ void modeRES_DIO( void )
 
   readData[0] = UM_ProbeICH_getAveADC(1);
   state = Buzzer_comp(readData[0], 50);
-  tmpData = UM_PROBE_ADCtoVol(readData[0]);
+  tmpData = UM_PROBE_ADCtoMilliVol(1, readData[0]);
   UM_UI_modeRES_DIO(tmpData, state);
 }
 
@@ -225,40 +297,126 @@ void modeWAV_Init( uint32_t mode )
 {
   UM_EXPAND_modeInit(MODE_WAV);
   UM_ProbeOCH_Cmd(DISABLE);
+  UM_ProbeICH_setSampleRate((mode == MODE_WAV_FFT) ? FFT_SAMPLE_RATE : WAV_SAMPLE_RATE);
+  UM_ProbeICH_setDifferential(DISABLE);
+  UM_ProbeICH_setRms(0);
+  UM_ProbeICH_setAverage(WAV_AVE_BITS, WAV_AVE_EMA);
+  /* Fft and Peak share WaveWork, only the one of this mode is set up */
+  if(mode == MODE_WAV_FFT) {
+    Fft_Init(&WaveWork.Fft, WAV_FFT_SIZE);
+    WaveCapture = UM_ProbeICH_getRing(WAV_FFT_SIZE);
+    UM_ProbeICH_setCapture(1, WaveCapture, WAV_FFT_SIZE);
+  }
+  else {
+    UM_ProbeICH_setCapture(0, NULL, 0);
+    Peak_Start(&WaveWork.Peak, 0);   // no cells of the other channel
+  }
+  Trig_Arm(&WaveTrig);
+  for(uint8_t i = 0; i < MEAS_WAV_NUM; i++)
+    WaveMeasure[i] = 0;
   UM_UI_modeWAV_Init(mode);
+  WaveForm.Redraw = ENABLE;
+  WaveForm.Mark = 0;
   itemWAV[mode].pFunc();
 }
+static void modeWAV_Measure( uint8_t channel )
+{
+  const MeasResult_Struct *pResult = &WaveMeas.Result;
+  uint32_t rate = UM_ProbeICH_getMeasure(&WaveMeas);
+  int32_t  mean = 0;
+  int32_t  ac = 0;
+
+  if(rate == 0)
+    return;
+
+  /* AC part through the gain only, total RMS from DC and AC */
+  mean = UM_PROBE_ADCtoVol(channel, pResult->Mean, 8) / 1000;
+  ac   = UM_PROBE_ADCtoVol(channel, pResult->Mean + pResult->Rms, 8) / 1000 - mean;
+  WaveMeasure[MEAS_WAV_MAX]  = UM_PROBE_ADCtoMilliVol(channel, pResult->Max);
+  WaveMeasure[MEAS_WAV_MIN]  = UM_PROBE_ADCtoMilliVol(channel, pResult->Min);
+  WaveMeasure[MEAS_WAV_AVG]  = mean;
+  WaveMeasure[MEAS_WAV_RMS]  = Rms_sqrtQ30((uint32_t)(mean * mean) + (uint32_t)(ac * ac));
+  WaveMeasure[MEAS_WAV_FREQ] = (pResult->Period != 0) ? ((uint64_t)rate << 8) / pResult->Period : 0;
+  WaveMeasure[MEAS_WAV_DUTY] = pResult->Duty * 100;
+  WaveMeasure[MEAS_WAV_RISE] = ((uint64_t)pResult->Rise * 1000000000) / ((uint64_t)rate << 8);
+  WaveMeasure[MEAS_WAV_FALL] = ((uint64_t)pResult->Fall * 1000000000) / ((uint64_t)rate << 8);
+}
+static uint8_t modeWAV_Burst( uint8_t channel )
+{
+  uint8_t state = UM_ProbeICH_getTrigger(channel, &WaveTrig, &WaveWork.Peak, WAV_PEAK_DEPTH);
+
+  if((state == TRIG_STATE_TRIG) || (state == TRIG_STATE_AUTO)) {
+    WaveFrame = ENABLE;
+    modeWAV_Measure(channel);
+  }
+
+  return state;
+}
+static uint8_t modeWAV_Columns( uint8_t channel )
+{
+  uint16_t high[WaveBarW] = {0};
+  uint16_t low[WaveBarW] = {0};
+  int32_t  first = (WaveWork.Peak.Mark >> WaveZoom) - WaveBarW * WaveTrig.PreTrig / 100;
+
+  if((WaveFrame != ENABLE) || (Peak_Cells(&WaveWork.Peak, WaveZoom) == 0))
+    return DISABLE;
+  WaveFrame = DISABLE;
+
+  /* one cell per column, the trigger stays on the same column at every zoom */
+  Peak_Columns(&WaveWork.Peak, WaveZoom, (first > 0) ? first : 0, high, low, WaveBarW);
+  for(uint8_t i = 0; i < WaveBarW; i++) {
+    WaveHigh[i] = UM_PROBE_ADCtoMilliVol(channel, high[i]);
+    WaveLow[i]  = UM_PROBE_ADCtoMilliVol(channel, low[i]);
+  }
+
+  return ENABLE;
+}
 void modeWAV_CH1( void )
 {
-  uint16_t readData[2] = {0};
+  uint8_t state = modeWAV_Burst(1);
+  uint8_t frame = modeWAV_Columns(1);
 
-  readData[0] = UM_ProbeICH_getAveADC(1);
-  readData[1] = UM_ProbeICH_getAveADC(2);
-  WaveForm.Data[0] = UM_PROBE_ADCtoVol(readData[0]);
-  UM_UI_modeWAV_CH1(&WaveForm);
+  UM_UI_modeWAV_CH1(&WaveForm, (frame == ENABLE) ? WaveHigh : NULL, WaveLow, WaveMeasure, HAL_GetTick() / WAV_MEAS_PAGE, UM_PROBE_ADCtoMilliVol(1, WaveTrig.Level), state);
 }
 void modeWAV_CH2( void )
+{
+  uint8_t state = modeWAV_Burst(2);
+  uint8_t frame = modeWAV_Columns(2);
+
+  UM_UI_modeWAV_CH2(&WaveForm, (frame == ENABLE) ? WaveHigh : NULL, WaveLow, WaveMeasure, HAL_GetTick() / WAV_MEAS_PAGE, UM_PROBE_ADCtoMilliVol(2, WaveTrig.Level), state);
+}
+void modeWAV_ALL( void )
 {
   uint16_t readData[2] = {0};
+  uint32_t blockCount = UM_ProbeICH_getBlockCount();
+
+  if(blockCount == WaveBlockCount)  // one column per new block, fixed time axis
+    return;
+  WaveBlockCount = blockCount;
 
   readData[0] = UM_ProbeICH_getAveADC(1);
   readData[1] = UM_ProbeICH_getAveADC(2);
-  WaveForm.Data[0] = UM_PROBE_ADCtoVol(readData[1]);
-  UM_UI_modeWAV_CH2(&WaveForm);
+  WaveForm.Data[0] = UM_PROBE_ADCtoMilliVol(1, readData[0]);
+  WaveForm.Data[1] = UM_PROBE_ADCtoMilliVol(2, readData[1]);
+  UM_UI_modeWAV_ALL(&WaveForm);
 }
-void modeWAV_ALL( void )
+void modeWAV_FFT( void )
 {
-  // DEMO
-  float data = 0.0f;
-  static float rad = 0.0f;
+  uint32_t peak = 0;
+  uint8_t mark = 0;
 
-  rad += 0.05f;
-  for(uint8_t i = 1; i < 10; i = i + 2)
-    data += (1.0f / i) * sinf(i * rad);
+  if(UM_ProbeICH_getCapture() < WAV_FFT_SIZE)
+    return;
 
-  WaveForm.Data[0] = sinf(rad) * 2300;
-  WaveForm.Data[1] = data * 2300;
-  UM_UI_modeWAV_ALL(&WaveForm);
+  /* next capture fills while this one is transformed */
+  Fft_Load(&WaveWork.Fft, WaveCapture);
+  UM_ProbeICH_setCapture(1, WaveCapture, WAV_FFT_SIZE);
+  Fft_Run(&WaveWork.Fft);
+  Fft_Columns(&WaveWork.Fft, WaveColumn, WaveBarW);
+
+  peak = Fft_Peak(&WaveWork.Fft);
+  mark = (((peak + 128) >> 8) * WaveBarW) / (WAV_FFT_SIZE / 2);
+  UM_UI_modeWAV_FFT(&WaveForm, WaveColumn, mark, ((uint64_t)peak * FFT_SAMPLE_RATE / WAV_FFT_SIZE) >> 8);
 }
 void modeWAV_EXP( void )
 {
@@ -305,6 +463,120 @@ void modeEXP_NUL( void )
 /*====================================================================================================*/
 /*====================================================================================================*/
 #define DeBounce 200
+#define CalibRepeat 100
+#define CalibHold 20    // x CalibRepeat, U + D held 2 s enter / leave the calibration
+static uint8_t VolCalib = 0;        // channel under calibration, 0 - off
+static uint8_t VolCalibHold = 0;
+static int16_t VolCalibTrim = 0;    // gain steps since entering
+static void modeVOL_CalibEnd( FunctionalState save )
+{
+  UM_PROBE_calibEnd(save);
+  VolCalib = 0;
+  UM_UI_modeVOL_putCalib(0, 0);
+}
+static void modeVOL_Calib( uint32_t mode )
+{
+  uint8_t channel = (mode == MODE_VOL_CH1) ? 1 : (mode == MODE_VOL_CH2) ? 2 : (mode == MODE_VOL_DIF) ? UM_PROBE_CH_DIF : 0;
+  uint32_t adcData = 0;
+
+  /* U + D held enter, reference on the input, U / D trim the reading, a short U + D with the input
+     shorted sets zero, P saves, holding U + D again drops the trims, nothing is written without P */
+  if(channel == 0)
+    return;
+  if(KEY_U_Read() && KEY_D_Read()) {
+    if((VolCalibHold < CalibHold) && (++VolCalibHold == CalibHold)) {
+      if(VolCalib)
+        modeVOL_CalibEnd(DISABLE);
+      else {
+        UM_PROBE_calibStart();
+        VolCalib = channel;
+        VolCalibTrim = 0;
+        UM_UI_modeVOL_putCalib(1, VolCalibTrim);
+      }
+    }
+    delay_ms(CalibRepeat);
+    return;
+  }
+  if(VolCalibHold) {
+    if(KEY_U_Read() || KEY_D_Read())  // one of the pair still down
+      return;
+    if(VolCalib && (VolCalibHold < CalibHold)) {
+      adcData = (channel == UM_PROBE_CH_DIF) ? UM_ProbeICH_getDifADC() : UM_ProbeICH_getOverADC(channel);
+      UM_PROBE_calibZero(channel, adcData, UM_ProbeICH_getOverBits());
+    }
+    VolCalibHold = 0;
+    return;
+  }
+  if(!VolCalib)
+    return;
+  if(KEY_U_Read()) {
+    UM_PROBE_calibGain(channel, 1);
+    UM_UI_modeVOL_putCalib(1, ++VolCalibTrim);
+    delay_ms(CalibRepeat);
+  }
+  else if(KEY_D_Read()) {
+    UM_PROBE_calibGain(channel, -1);
+    UM_UI_modeVOL_putCalib(1, --VolCalibTrim);
+    delay_ms(CalibRepeat);
+  }
+}
+static void modeWAV_Zoom( int8_t zoom )
+{
+  if((zoom < PEAK_LEVEL_MIN) || (zoom > PEAK_LEVEL_MAX))
+    return;
+
+  /* the held capture is redrawn from its cells, no new burst */
+  WaveZoom = zoom;
+  WaveFrame = ENABLE;
+}
+static void modeWAV_Level( uint8_t channel, int8_t rows )
+{
+  int32_t level = UM_PROBE_ADCtoMilliVol(channel, WaveTrig.Level) + rows * WaveForm.Scale[1];
+  uint16_t code = UM_PROBE_VolToADC(channel, level * 1000);
+
+  /* whole trace rows, the mark moves with every step, at least one code */
+  if(code == WaveTrig.Level)
+    code += (rows > 0) ? 1 : -1;
+  Trig_setLevel(&WaveTrig, code);
+}
+static void modeWAV_Trigger( uint32_t mode )
+{
+  uint8_t channel = (mode == MODE_WAV_CH2) ? 2 : 1;
+  int8_t  rows = (WaveTrigHold < WAV_TRIG_FAST) ? 1 : 4;
+
+  if((mode != MODE_WAV_CH1) && (mode != MODE_WAV_CH2))
+    return;
+
+  /* U / D move the level, or zoom a held single shot in / out, the next frames keep the zoom,
+     both together re-arm a held single shot or step AUTO, NORMAL, SINGLE */
+  if(KEY_U_Read() && KEY_D_Read()) {
+    if(WaveTrig.State != TRIG_STATE_HOLD)
+      WaveTrig.Mode = (WaveTrig.Mode + 1) % TRIG_MODE_MAX;
+    Trig_Arm(&WaveTrig);
+    delay_ms(DeBounce);
+  }
+  else if(KEY_U_Read() && (WaveTrig.State == TRIG_STATE_HOLD)) {
+    modeWAV_Zoom(WaveZoom - 1);
+    delay_ms(DeBounce);
+  }
+  else if(KEY_D_Read() && (WaveTrig.State == TRIG_STATE_HOLD)) {
+    modeWAV_Zoom(WaveZoom + 1);
+    delay_ms(DeBounce);
+  }
+  else if(KEY_U_Read()) {
+    modeWAV_Level(channel, rows);
+    WaveTrigHold += (WaveTrigHold < WAV_TRIG_FAST);
+    delay_ms(CalibRepeat);
+  }
+  else if(KEY_D_Read()) {
+    modeWAV_Level(channel, -rows);
+    WaveTrigHold += (WaveTrigHold < WAV_TRIG_FAST);
+    delay_ms(CalibRepeat);
+  }
+  else {
+    WaveTrigHold = 0;
+  }
+}
 void UM_Run( void )
 {
   static int8_t updateState = 1;  // 1 - Update, 0 - No Update
@@ -323,7 +595,11 @@ void UM_Run( void )
       modeState_selNew = MODE_BDR_MAX - 1;
     delay_ms(DeBounce);
   }
-  if(KEY_P_Read()) {
+  if(KEY_P_Read() && VolCalib) {  // confirms the calibration, the page stays
+    modeVOL_CalibEnd(ENABLE);
+    delay_ms(DeBounce);
+  }
+  else if(KEY_P_Read()) {
     if(modeState_selOld == modeState_selNew) {
       topPage.pPage[topPage.mode].mode++;
       if(topPage.pPage[topPage.mode].mode == topPage.pPage[topPage.mode].itemNum)
@@ -333,6 +609,10 @@ void UM_Run( void )
     topPage.mode = modeState_selNew;
     delay_ms(DeBounce);
   }
+  if(topPage.mode == MODE_VOL)
+    modeVOL_Calib(menuPage[MODE_VOL].mode);
+  if(topPage.mode == MODE_WAV)
+    modeWAV_Trigger(menuPage[MODE_WAV].mode);
 
   topPage.Init(Byte16(uint32_t, modeState_selNew, topPage.pPage[topPage.mode].mode));
 
@@ -340,12 +620,15 @@ void UM_Run( void )
     modeState_selOld = topPage.mode;
     updateState = 0;
     Buzzer_beep(BUZZER_OFF);
+    OLED_SetColorMode((topPage.mode == MODE_WAV) ? OLED_COLOR_256 : OLED_COLOR_65K);  // WAV redraws most, 1 byte per pixel
     menuPage[topPage.mode].Init(topPage.pPage[modeState_selNew].mode);  // init
   }
   else {
     menuPage[topPage.mode].pItem[menuPage[topPage.mode].mode].pFunc(); // run
   }
 
+  OLED_Flush();
+
 //  uMultimeter_expandMode();
 }
 /*====================================================================================================*/
@@ -81,6 +81,7 @@ void UM_OLED_Config( void )
   delay_ms(100);
   SSD1331_Init();
   OLED_TestColoBar();
+  OLED_Flush();
 }
 /*====================================================================================================*/
 /*====================================================================================================*/
@@ -77,6 +77,9 @@ void UM_EXPAND_modeVol( uint32_t mode )
     case MODE_VOL_DIF:
       EXPAND_PROBEA_SW_Reset();
       break;
+    case MODE_VOL_AC:
+      EXPAND_PROBEA_SW_Set();
+      break;
   }
 }
 /*====================================================================================================*/
@@ -1,6 +1,8 @@
 /*====================================================================================================*/
 /*====================================================================================================*/
 #include "drivers\stm32f3_system.h"
+#include "drivers\stm32f3_spi.h"
+#include "drivers\stm32f3_adc.h"
 /*====================================================================================================*/
 /*====================================================================================================*/
 void NMI_Handler( void ) { while(1); }
@@ -68,7 +70,8 @@ void SysTick_Handler( void ) { HAL_IncTick(); }
 //void TIM6_DAC_IRQHandler( void )
 //void TIM7_IRQHandler( void )
 //void DMA2_Channel1_IRQHandler( void )
-//void DMA2_Channel2_IRQHandler( void )
+void DMA1_Channel1_IRQHandler( void ) { ADC_DMA_IRQHandler(); }
+void DMA2_Channel2_IRQHandler( void ) { SPI_DMA_IRQHandler(); }
 //void DMA2_Channel3_IRQHandler( void )
 //void DMA2_Channel4_IRQHandler( void )
 //void DMA2_Channel5_IRQHandler( void )
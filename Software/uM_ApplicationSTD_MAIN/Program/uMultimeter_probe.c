@@ -3,9 +3,53 @@
 #include "drivers\stm32f3_system.h"
 #include "drivers\stm32f3_adc.h"
 #include "drivers\stm32f3_tim_pwm.h"
+#include "drivers\stm32f3_flash.h"
+#include "algorithms\algorithm_moveAve.h"
+#include "algorithms\algorithm_rms.h"
 
 #include "uMultimeter.h"
 #include "uMultimeter_probe.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define VREFINT_CAL     (*(const uint16_t *)0x1FFFF7BA)   // VREFINT at VDDA = 3.3 V
+#define TS_CAL1         (*(const uint16_t *)0x1FFFF7B8)   // temperature sensor at 30 C, 3.3 V
+#define TS_CAL2         (*(const uint16_t *)0x1FFFF7C2)   // temperature sensor at 110 C, 3.3 V
+
+static MoveAve_Struct UM_ProbeAve[ADC_BUF_CHENNAL];   // CH1, CH2, VREFINT, temperature
+static uint8_t UM_ProbeOverBits = 0;
+static __IO int32_t UM_ProbeVddaRatio = 1 << 16;     // VDDA / 3.3 V, Q16
+static Rms_Struct UM_ProbeRms;
+static __IO uint8_t UM_ProbeRmsChannel = 0;          // 0 - off
+static uint16_t *UM_ProbeCapBuf = NULL;
+static uint16_t UM_ProbeCapLens = 0;
+static __IO uint16_t UM_ProbeCapCount = 0;
+static uint8_t  UM_ProbeCapChannel = 0;
+static uint16_t UM_ProbeRing[UM_PROBE_RING_SIZE];   // burst DMA, SRAM, free between triggers
+static uint32_t UM_ProbeRingFirst = 0;               // window of the last trigger frame
+static uint32_t UM_ProbeRingSpan = 0;
+
+static void UM_PROBE_Block( const uint16_t *pBlock )
+{
+  uint32_t vref = 0;
+
+  MoveAve_PushPair(&UM_ProbeAve[0], (const uint32_t *)pBlock, ADC_BLOCK_SIZE, ADC_BUF_CHENNAL / 2);
+  MoveAve_PushPair(&UM_ProbeAve[ADC_CH_VREFINT - 1], (const uint32_t *)pBlock + 1, ADC_BLOCK_SIZE, ADC_BUF_CHENNAL / 2);
+  if(UM_ProbeRmsChannel != 0)
+    Rms_Push(&UM_ProbeRms, pBlock + UM_ProbeRmsChannel - 1, ADC_BLOCK_SIZE, ADC_BUF_CHENNAL);
+
+  /* consecutive blocks, no gap at the sample rate */
+  for(uint16_t i = 0; (i < ADC_BLOCK_SIZE) && (UM_ProbeCapCount < UM_ProbeCapLens); i++)
+    UM_ProbeCapBuf[UM_ProbeCapCount++] = pBlock[i * ADC_BUF_CHENNAL + UM_ProbeCapChannel - 1];
+
+  /* VREFINT reads high when VDDA sags, every conversion scales by the same ratio */
+  vref = MoveAve_GetBits(&UM_ProbeAve[ADC_CH_VREFINT - 1], 4);
+  if(vref != 0)
+    UM_ProbeVddaRatio = ((uint32_t)VREFINT_CAL << 20) / vref;
+}
 /*====================================================================================================*/
 /*====================================================================================================*
 **函數 : UM_PROBE_Config
@@ -17,7 +61,14 @@
 /*====================================================================================================*/
 void UM_PROBE_Config( void )
 {
+  ErrorStatus stored = UM_PROBE_loadCalib();   // a stored ADC factor skips the self calibration
+
+  for(uint8_t i = 0; i < ADC_BUF_CHENNAL; i++)
+    MoveAve_Init(&UM_ProbeAve[i], UM_PROBE_AVE_BITS, UM_PROBE_AVE_EMA);
+  ADC_setBlockCallback(UM_PROBE_Block);
   ADC_Config();
+  if(stored != SUCCESS)
+    UM_PROBE_saveCalib();   // first boot, the self calibration and the default gains, once
 
   TIM_PWM_Config();
   TIM_PWM_setDuty(0);
@@ -112,16 +163,484 @@ uint16_t UM_ProbeICH_getADC( uint8_t channel )
 }
 /*====================================================================================================*/
 /*====================================================================================================*
-**函數 : UM_ProbeICH_getADC
-**功能 : get ADC Data
+**函數 : UM_ProbeICH_getAveADC
+**功能 : get Running Average ADC Data
 **輸入 : channel
 **輸出 : adcData
-**使用 : adc = UM_ProbeICH_getADC(channel);
+**使用 : adc = UM_ProbeICH_getAveADC(channel);
 **====================================================================================================*/
 /*====================================================================================================*/
 uint16_t UM_ProbeICH_getAveADC( uint8_t channel )
 {
-  return ADC_getData(channel);
+  if((channel == 0) || (channel > ADC_BUF_CHENNAL))
+    return 0;
+
+  return MoveAve_Get(&UM_ProbeAve[channel - 1]);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_setAverage
+**功能 : set Average Window (2^windowBits samples) and EMA Shift (0 - off)
+**輸入 : windowBits, emaShift
+**輸出 : None
+**使用 : UM_ProbeICH_setAverage(10, 4);
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_ProbeICH_setAverage( uint8_t windowBits, uint8_t emaShift )
+{
+  __disable_irq();
+  for(uint8_t i = 0; i < ADC_PROBE_CHENNAL; i++)
+    MoveAve_Init(&UM_ProbeAve[i], windowBits, emaShift);
+  __enable_irq();
+  UM_ProbeOverBits = 0;
+  ADC_setJitter(DISABLE);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_setOverSample
+**功能 : Oversample 4^bits and Decimate, +bits of Resolution
+**輸入 : bits, jitter
+**輸出 : None
+**使用 : UM_ProbeICH_setOverSample(4, ENABLE);  // 256 samples, 16-bit result
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_ProbeICH_setOverSample( uint8_t bits, FunctionalState jitter )
+{
+  if(bits > UM_PROBE_OVS_MAX)
+    bits = UM_PROBE_OVS_MAX;
+
+  UM_ProbeICH_setAverage(bits << 1, UM_PROBE_AVE_EMA);
+  UM_ProbeOverBits = bits;
+  ADC_setJitter(jitter);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getOverADC
+**功能 : get Oversampled ADC Data, 12 + UM_ProbeICH_getOverBits() bits
+**輸入 : channel
+**輸出 : adcData
+**使用 : adc = UM_ProbeICH_getOverADC(channel);
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t UM_ProbeICH_getOverADC( uint8_t channel )
+{
+  if((channel == 0) || (channel > ADC_BUF_CHENNAL))
+    return 0;
+
+  return MoveAve_GetBits(&UM_ProbeAve[channel - 1], UM_ProbeOverBits);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getOverBits
+**功能 : get Extra Bits of UM_ProbeICH_getOverADC()
+**輸入 : None
+**輸出 : bits
+**使用 : bits = UM_ProbeICH_getOverBits();
+**====================================================================================================*/
+/*====================================================================================================*/
+uint8_t UM_ProbeICH_getOverBits( void )
+{
+  return UM_ProbeOverBits;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_setDifferential
+**功能 : Both Probe Ranks Convert PA2 - PA3 Differential
+**輸入 : state
+**輸出 : None
+**使用 : UM_ProbeICH_setDifferential(ENABLE);
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_ProbeICH_setDifferential( FunctionalState state )
+{
+  if(state == ADC_getDifferential())
+    return;
+
+  ADC_setDifferential(state);
+
+  /* the windows hold samples of the other mode */
+  __disable_irq();
+  for(uint8_t i = 0; i < ADC_PROBE_CHENNAL; i++)
+    MoveAve_Init(&UM_ProbeAve[i], UM_ProbeAve[i].WindowBits, UM_ProbeAve[i].EmaShift);
+  __enable_irq();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getDifADC
+**功能 : get Oversampled Differential ADC Data, Ranks 1 and 2 Together
+**輸入 : None
+**輸出 : adcData, 2048 << UM_ProbeICH_getOverBits() at 0 V
+**使用 : adc = UM_ProbeICH_getDifADC();  // convert with UM_PROBE_CH_DIF
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t UM_ProbeICH_getDifADC( void )
+{
+  return (MoveAve_GetBits(&UM_ProbeAve[0], UM_ProbeOverBits) + MoveAve_GetBits(&UM_ProbeAve[1], UM_ProbeOverBits) + 1) >> 1;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_setRms
+**功能 : True RMS of One Channel in the Block Callback, Set the Sample Rate First
+**輸入 : channel, 0 - off
+**輸出 : None
+**使用 : UM_ProbeICH_setRms(1);
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_ProbeICH_setRms( uint8_t channel )
+{
+  if(channel > ADC_PROBE_CHENNAL)
+    channel = 0;
+
+  __disable_irq();
+  UM_ProbeRmsChannel = channel;
+  Rms_Init(&UM_ProbeRms, ADC_getSampleRate() / UM_PROBE_RMS_RATE);
+  __enable_irq();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getAC
+**功能 : get the Last True RMS Result in uV
+**輸入 : *pAC
+**輸出 : result count, 0 - none yet
+**使用 : UM_ProbeICH_getAC(&ac);
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t UM_ProbeICH_getAC( UM_ProbeAC_Struct *pAC )
+{
+  RmsResult_Struct result;
+  uint32_t count = Rms_Get(&UM_ProbeRms, &result);
+  uint32_t adcData = (int32_t)result.Mean + (2048 << UM_PROBE_RMS_BITS);   // q15 is a 15-bit reading around mid scale
+
+  pAC->Dc    = UM_PROBE_ADCtoVol(UM_ProbeRmsChannel, adcData, UM_PROBE_RMS_BITS);
+  pAC->Rms   = UM_PROBE_ADCtoVol(UM_ProbeRmsChannel, adcData + result.Rms, UM_PROBE_RMS_BITS) - pAC->Dc;
+  pAC->Crest = (result.Rms != 0) ? (uint16_t)(((uint32_t)result.Peak * 100 + (result.Rms >> 1)) / result.Rms) : 0;
+  pAC->Freq  = (result.Period != 0) ? (uint32_t)(((uint64_t)ADC_getSampleRate() * 256000 + (result.Period >> 1)) / result.Period) : 0;
+
+  return count;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_setCapture
+**功能 : Copy lens Samples of One Channel from the Next Blocks, One Shot
+**輸入 : channel, *pBuf, lens
+**輸出 : None
+**使用 : UM_ProbeICH_setCapture(1, capture, 1024);  // done when UM_ProbeICH_getCapture() == 1024
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_ProbeICH_setCapture( uint8_t channel, uint16_t *pBuf, uint16_t lens )
+{
+  if((channel == 0) || (channel > ADC_PROBE_CHENNAL) || (pBuf == NULL))
+    lens = 0;
+
+  __disable_irq();
+  UM_ProbeCapBuf     = pBuf;
+  UM_ProbeCapChannel = channel;
+  UM_ProbeCapLens    = lens;
+  UM_ProbeCapCount   = 0;
+  if(pBuf == UM_ProbeRing)
+    UM_ProbeRingSpan = 0;   // the last trigger frame is overwritten
+  __enable_irq();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getCapture
+**功能 : get Number of Captured Samples
+**輸入 : None
+**輸出 : count
+**使用 : if(UM_ProbeICH_getCapture() == 1024) { ... }
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t UM_ProbeICH_getCapture( void )
+{
+  return UM_ProbeCapCount;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getVdda
+**功能 : get VDDA from VREFINT
+**輸入 : None
+**輸出 : mV
+**使用 : vdda = UM_ProbeICH_getVdda();
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t UM_ProbeICH_getVdda( void )
+{
+  return (uint16_t)((3300 * UM_ProbeVddaRatio + 0x8000) >> 16);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getTemp
+**功能 : get Chip Temperature
+**輸入 : None
+**輸出 : 0.1 C
+**使用 : temp = UM_ProbeICH_getTemp();  // 253 = 25.3 C
+**====================================================================================================*/
+/*====================================================================================================*/
+int16_t UM_ProbeICH_getTemp( void )
+{
+  int32_t ts = MoveAve_GetBits(&UM_ProbeAve[ADC_CH_TEMP - 1], 4);
+
+  ts = (int32_t)(((int64_t)ts * UM_ProbeVddaRatio) >> 16);   // as read at VDDA = 3.3 V, Q4
+
+  return (int16_t)(300 + (ts - ((int32_t)TS_CAL1 << 4)) * 800 / (((int32_t)TS_CAL2 - TS_CAL1) << 4));
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_setSampleRate
+**功能 : Set ADC Sample Rate
+**輸入 : sampleRate
+**輸出 : real sample rate
+**使用 : UM_ProbeICH_setSampleRate(3200);  // 3.2 kHz
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t UM_ProbeICH_setSampleRate( uint32_t sampleRate )
+{
+  return ADC_setSampleRate(sampleRate);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getBlockCount
+**功能 : get Number of Completed ADC Blocks
+**輸入 : None
+**輸出 : count
+**使用 : if(UM_ProbeICH_getBlockCount() != lastCount) { ... }
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t UM_ProbeICH_getBlockCount( void )
+{
+  return ADC_getBlockCount();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getRing
+**功能 : Lend the Burst Ring as a Capture Buffer
+**輸入 : lens
+**輸出 : *pRing, NULL - lens over the ring
+**使用 : capture = UM_ProbeICH_getRing(1024);  // no UM_ProbeICH_getTrigger() while it is in use
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t *UM_ProbeICH_getRing( uint16_t lens )
+{
+  return (lens <= UM_PROBE_RING_SIZE) ? UM_ProbeRing : NULL;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getTrigger
+**功能 : Burst into the Ring until a Trigger, Reduce the Window around It to Min / Max Cells
+**輸入 : channel, *pTrig, *pPeak, depth
+**輸出 : TRIG_STATE_xxx, pPeak is rebuilt for TRIG and AUTO only
+**使用 : state = UM_ProbeICH_getTrigger(1, &trig, &peak, 752);  // 94 columns of 8 samples at the widest
+**====================================================================================================*/
+/*====================================================================================================*/
+uint8_t UM_ProbeICH_getTrigger( uint8_t channel, Trig_Struct *pTrig, Peak_Struct *pPeak, uint16_t depth )
+{
+  uint32_t span = depth & ~((1 << PEAK_LEVEL_MAX) - 1);
+  uint32_t pre = (span * pTrig->PreTrig / 100) & ~((1 << PEAK_LEVEL_MAX) - 1);  // trigger on a cell edge at every level
+  uint32_t written = 0;
+  uint32_t scanned = pre;
+  uint32_t found = TRIG_NONE;
+  uint32_t first = 0;
+  uint32_t start = 0;
+  uint32_t num = 0;
+  uint16_t index = 0;
+  uint16_t last = 0;
+
+  if(pTrig->State == TRIG_STATE_HOLD)
+    return TRIG_STATE_HOLD;
+  if((span == 0) || (span > UM_PROBE_RING_SIZE / 2) || (ADC_startBurst(channel, UM_ProbeRing, UM_PROBE_RING_SIZE) == 0))
+    return TRIG_STATE_WAIT;
+  pTrig->Armed = 0;
+
+  /* written counts samples since the start, the loop polls DMA well within one wrap */
+  while(1) {
+    index = ADC_getBurstIndex();
+    written += (index - last) & (UM_PROBE_RING_SIZE - 1);
+    last = index;
+
+    if(found != TRIG_NONE) {
+      if(written >= found - pre + span)
+        break;
+      continue;
+    }
+    /* too far behind, the pre-trigger part would be overwritten before the window is complete */
+    if((written > scanned) && (written - scanned > UM_PROBE_RING_SIZE - span)) {
+      scanned = written - (UM_PROBE_RING_SIZE - span);
+      pTrig->Armed = 0;
+    }
+    while((scanned < written) && (found == TRIG_NONE)) {
+      start = scanned & (UM_PROBE_RING_SIZE - 1);
+      num = written - scanned;
+      if(num > UM_PROBE_RING_SIZE - start)
+        num = UM_PROBE_RING_SIZE - start;
+      found = Trig_Scan(pTrig, &UM_ProbeRing[start], num);
+      if(found != TRIG_NONE)
+        found += scanned;
+      scanned += num;
+    }
+    if((found == TRIG_NONE) && (written >= UM_PROBE_RING_SIZE * UM_PROBE_TRIG_WAIT))
+      break;
+  }
+  ADC_stopBurst();
+
+  if(found != TRIG_NONE) {
+    first = found - pre;
+    pTrig->State = TRIG_STATE_TRIG;
+  }
+  else if(pTrig->Mode == TRIG_MODE_AUTO) {
+    first = written - span;
+    pTrig->State = TRIG_STATE_AUTO;
+  }
+  else {
+    pTrig->State = TRIG_STATE_WAIT;
+    return TRIG_STATE_WAIT;
+  }
+
+  /* every sample of the window lands in a cell, a spike between display columns is not lost */
+  UM_ProbeRingFirst = first;
+  UM_ProbeRingSpan = span;
+  start = first & (UM_PROBE_RING_SIZE - 1);
+  num = span;
+  Peak_Start(pPeak, span);
+  pPeak->Mark = pre;
+  if(start + num > UM_PROBE_RING_SIZE) {
+    Peak_Push(pPeak, &UM_ProbeRing[start], UM_PROBE_RING_SIZE - start);
+    num -= UM_PROBE_RING_SIZE - start;
+    start = 0;
+  }
+  Peak_Push(pPeak, &UM_ProbeRing[start], num);
+
+  if((pTrig->State == TRIG_STATE_TRIG) && (pTrig->Mode == TRIG_MODE_SINGLE)) {
+    pTrig->State = TRIG_STATE_HOLD;
+    return TRIG_STATE_TRIG;
+  }
+
+  return pTrig->State;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getMeasure
+**功能 : Measure the Full Rate Samples behind the Last Trigger Frame
+**輸入 : *pMeas
+**輸出 : sample rate, 0 - no frame yet
+**使用 : rate = UM_ProbeICH_getMeasure(&meas);  // after a TRIG or AUTO frame, results in meas.Result
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t UM_ProbeICH_getMeasure( Meas_Struct *pMeas )
+{
+  uint32_t start = UM_ProbeRingFirst & (UM_PROBE_RING_SIZE - 1);
+  uint32_t num = UM_ProbeRingSpan;
+
+  if(num == 0)
+    return 0;
+
+  /* the window may wrap, one pass in two parts */
+  Meas_Start(pMeas);
+  if(start + num > UM_PROBE_RING_SIZE) {
+    Meas_Push(pMeas, &UM_ProbeRing[start], UM_PROBE_RING_SIZE - start);
+    num -= UM_PROBE_RING_SIZE - start;
+    start = 0;
+  }
+  Meas_Push(pMeas, &UM_ProbeRing[start], num);
+  Meas_Finish(pMeas);
+
+  return ADC_BURST_RATE;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getPairs
+**功能 : get Time Aligned CH1 / CH2 Pairs of the Last Completed Block
+**輸入 : *pPair
+**輸出 : number of pairs, ADC_BLOCK_SIZE - 1
+**使用 : lens = UM_ProbeICH_getPairs(pair);  // UM_ProbePair_Struct pair[ADC_BLOCK_SIZE]
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t UM_ProbeICH_getPairs( UM_ProbePair_Struct *pPair )
+{
+  uint16_t block[ADC_BLOCK_SIZE][ADC_BUF_CHENNAL];
+  int32_t  skew = ADC_getChannelSkew();
+  int32_t  tmpData = 0;
+
+  ADC_getBlock(block[0]);
+
+  /* CH2 is converted one rank after CH1, move CH1 to the CH2 instant by linear interpolation */
+  for(uint16_t i = 0; i < ADC_BLOCK_SIZE - 1; i++) {
+    tmpData = block[i][0] + ((((int32_t)block[i + 1][0] - block[i][0]) * skew) >> 16);
+    pPair[i].CH1 = (uint16_t)tmpData;
+    pPair[i].CH2 = block[i][1];
+  }
+
+  return ADC_BLOCK_SIZE - 1;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_initPhase
+**功能 : Clear the Phase Sums
+**輸入 : *pPhase
+**輸出 : None
+**使用 : UM_ProbeICH_initPhase(&phase);  // on entering the mode
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_ProbeICH_initPhase( UM_ProbePhase_Struct *pPhase )
+{
+  memset(pPhase, 0, sizeof(UM_ProbePhase_Struct));
+  pPhase->Block = ADC_getBlockCount();
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_ProbeICH_getPhase
+**功能 : Phase between CH1 and CH2 from the Correlation of Aligned Pairs
+**輸入 : *pPhase
+**輸出 : 1 - new pPhase->Phase, 0 - still summing
+**使用 : UM_ProbeICH_getPhase(&phase);  // every pass, pairs of each new block, a result per UM_PROBE_PHASE_NUM pairs
+**====================================================================================================*/
+/*====================================================================================================*/
+uint32_t UM_ProbeICH_getPhase( UM_ProbePhase_Struct *pPhase )
+{
+  UM_ProbePair_Struct pair[ADC_BLOCK_SIZE];
+  uint32_t block = ADC_getBlockCount();
+  uint16_t lens = 0;
+  int64_t  c11 = 0;
+  int64_t  c22 = 0;
+  int64_t  c12 = 0;
+  float    corr = 0.0f;
+
+  if(block == pPhase->Block)
+    return 0;
+  pPhase->Block = block;
+
+  /* blocks taken at random points of the signal, the sums still cover whole periods on average */
+  lens = UM_ProbeICH_getPairs(pair);
+  for(uint16_t i = 0; i < lens; i++) {
+    pPhase->S1  += pair[i].CH1;
+    pPhase->S2  += pair[i].CH2;
+    pPhase->S11 += (uint32_t)pair[i].CH1 * pair[i].CH1;
+    pPhase->S22 += (uint32_t)pair[i].CH2 * pair[i].CH2;
+    pPhase->S12 += (uint32_t)pair[i].CH1 * pair[i].CH2;
+  }
+  pPhase->Num += lens;
+  if(pPhase->Num < UM_PROBE_PHASE_NUM)
+    return 0;
+
+  /* covariances x Num^2, exact in 64 bits, gains and offsets of the channels drop out */
+  c11 = (int64_t)(pPhase->Num * pPhase->S11) - (int64_t)pPhase->S1 * pPhase->S1;
+  c22 = (int64_t)(pPhase->Num * pPhase->S22) - (int64_t)pPhase->S2 * pPhase->S2;
+  c12 = (int64_t)(pPhase->Num * pPhase->S12) - (int64_t)pPhase->S1 * pPhase->S2;
+
+  /* cos of the phase for two sines, below one count RMS on either channel there is none */
+  if((c11 < (int64_t)pPhase->Num * pPhase->Num) || (c22 < (int64_t)pPhase->Num * pPhase->Num)) {
+    pPhase->Phase = 0;
+  }
+  else {
+    corr = (float)c12 / sqrtf((float)c11 * (float)c22);
+    if(corr > 1.0f)  corr = 1.0f;
+    if(corr < -1.0f) corr = -1.0f;
+    pPhase->Phase = (uint16_t)(acosf(corr) * (1800.0f / 3.14159265f) + 0.5f);
+  }
+
+  pPhase->S11 = pPhase->S22 = pPhase->S12 = 0;
+  pPhase->S1 = pPhase->S2 = pPhase->Num = 0;
+
+  return 1;
 }
 /*====================================================================================================*/
 /*====================================================================================================*
@@ -155,26 +674,235 @@ uint16_t UM_ProbeICH_getAveADC( uint8_t channel )
 //  return (uint16_t)(sumData >> 4);
 //}
 /*====================================================================================================*/
+/*====================================================================================================*/
+#define VADC            3300000 // 3300mV, uV
+#define ADC_R1          15000   // 15K
+#define ADC_R2          2000    //  2K
+#define ADC_DIVIDER     ((int32_t)(((int64_t)(ADC_R1 + ADC_R2) << 16) / ADC_R2))   // (R1 + R2) / R2, Q16
+#define ADC_GAIN(__DIV) ((int32_t)(((int64_t)VADC * (__DIV)) >> 12))              // (VIN_MAX / 4096) << 16, uV
+#define ADC_GAIN_DIF(__DIV) ((int32_t)(((int64_t)VADC * (__DIV)) >> 11))          // +-VIN_MAX over 4096 counts
+
+static UM_ProbeConv_Struct UM_ProbeConv[UM_PROBE_CONV_NUM] = {
+  {ADC_GAIN(ADC_DIVIDER), 0, {0}},  // CH1, 15k / 2k
+  {ADC_GAIN(ADC_DIVIDER), 0, {0}},  // CH2, 15k / 2k
+  {ADC_GAIN_DIF(ADC_DIVIDER), 0, {0}},  // DIF, both dividers
+};
+static int32_t UM_ProbeDivider[UM_PROBE_CONV_NUM] = {ADC_DIVIDER, ADC_DIVIDER, ADC_DIVIDER};
+static uint8_t UM_ProbeCalibDirty = 0;
+
+static UM_ProbeConv_Struct UM_ProbeConvKeep[UM_PROBE_CONV_NUM];   // before the field calibration
+static int32_t UM_ProbeDividerKeep[UM_PROBE_CONV_NUM];
+static uint8_t UM_ProbeCalibDirtyKeep = 0;
+/*====================================================================================================*/
 /*====================================================================================================*
-**函數 : uMultimeter_measure_ADCtoVol
-**功能 : 
-**輸入 : adcData
+**函數 : UM_PROBE_loadCalib
+**功能 : Load the Calibration Record from Flash
+**輸入 : None
+**輸出 : SUCCESS, ERROR - no valid record, defaults in use
+**使用 : UM_PROBE_loadCalib();  // before ADC_Config()
+**====================================================================================================*/
+/*====================================================================================================*/
+static uint32_t UM_PROBE_calibCRC( const UM_ProbeCalib_Struct *pCalib )
+{
+  const uint8_t *pByte = (const uint8_t *)pCalib;
+  uint32_t crc = 0xFFFFFFFF;
+
+  for(uint32_t i = 0; i < offsetof(UM_ProbeCalib_Struct, Crc); i++) {
+    crc ^= pByte[i];
+    for(uint8_t j = 0; j < 8; j++)
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+
+  return ~crc;
+}
+
+ErrorStatus UM_PROBE_loadCalib( void )
+{
+  UM_ProbeCalib_Struct calib;
+
+  FLASH_readData(UM_CALIB_ADDR, &calib, sizeof(UM_ProbeCalib_Struct));
+  if((calib.Magic != UM_CALIB_MAGIC) || (calib.Version != UM_CALIB_VERSION) ||
+     (calib.Size != sizeof(UM_ProbeCalib_Struct)) || (calib.Crc != UM_PROBE_calibCRC(&calib))) {
+    UM_ProbeCalibDirty = 1;   // UM_PROBE_Config() saves the first self calibration
+    return ERROR;
+  }
+
+  ADC_setCalibValue(calib.AdcCalib);
+  for(uint8_t i = 0; i < UM_PROBE_CONV_NUM; i++) {
+    UM_ProbeDivider[i] = calib.Divider[i];
+    UM_ProbeConv[i] = calib.Conv[i];
+  }
+  UM_ProbeCalibDirty = 0;
+
+  return SUCCESS;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_PROBE_saveCalib
+**功能 : Write the Calibration Record if Changed
+**輸入 : None
+**輸出 : SUCCESS / ERROR
+**使用 : UM_PROBE_saveCalib();  // UM_PROBE_calibEnd(ENABLE) on a confirmed calibration, stalls for a page erase
+**====================================================================================================*/
+/*====================================================================================================*/
+ErrorStatus UM_PROBE_saveCalib( void )
+{
+  UM_ProbeCalib_Struct calib;
+
+  if(!UM_ProbeCalibDirty)
+    return SUCCESS;
+
+  memset(&calib, 0, sizeof(UM_ProbeCalib_Struct));
+  calib.Magic    = UM_CALIB_MAGIC;
+  calib.Version  = UM_CALIB_VERSION;
+  calib.Size     = sizeof(UM_ProbeCalib_Struct);
+  calib.AdcCalib = ADC_getCalibValue();
+  for(uint8_t i = 0; i < UM_PROBE_CONV_NUM; i++) {
+    calib.Divider[i] = UM_ProbeDivider[i];
+    calib.Conv[i] = UM_ProbeConv[i];
+  }
+  calib.Crc = UM_PROBE_calibCRC(&calib);
+
+  if(FLASH_writePage(UM_CALIB_ADDR, &calib, sizeof(UM_ProbeCalib_Struct)) != SUCCESS)
+    return ERROR;
+  UM_ProbeCalibDirty = 0;
+
+  return SUCCESS;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_PROBE_calibStart
+**功能 : Keep the Present Calibration, the Trims from Here on can be Dropped
+**輸入 : None
 **輸出 : None
-**使用 : tmpData = uMultimeter_measure_ADCtoVol(readData);
+**使用 : UM_PROBE_calibStart();  // entering the calibration, before UM_PROBE_calibGain()
 **====================================================================================================*/
 /*====================================================================================================*/
-#define VADC            3300.0  // 3300mV
-#define ADC_R1          15000   // 15K
-#define ADC_R2          2000    //  2K
-#define VIN_MAX         (VADC * (ADC_R1 + ADC_R2) / ADC_R2)   //  2K
-#define ADC_RESOLUTION  (6.84814453125) // (VIN_MAX / 4096)
+void UM_PROBE_calibStart( void )
+{
+  for(uint8_t i = 0; i < UM_PROBE_CONV_NUM; i++) {
+    UM_ProbeDividerKeep[i] = UM_ProbeDivider[i];
+    UM_ProbeConvKeep[i] = UM_ProbeConv[i];
+  }
+  UM_ProbeCalibDirtyKeep = UM_ProbeCalibDirty;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_PROBE_calibEnd
+**功能 : Save the Trims since UM_PROBE_calibStart(), or Drop Them
+**輸入 : save
+**輸出 : SUCCESS / ERROR
+**使用 : UM_PROBE_calibEnd(ENABLE);  // confirmed, DISABLE restores the kept calibration
+**====================================================================================================*/
+/*====================================================================================================*/
+ErrorStatus UM_PROBE_calibEnd( FunctionalState save )
+{
+  if(save == ENABLE)
+    return UM_PROBE_saveCalib();
+
+  for(uint8_t i = 0; i < UM_PROBE_CONV_NUM; i++) {
+    UM_ProbeDivider[i] = UM_ProbeDividerKeep[i];
+    UM_ProbeConv[i] = UM_ProbeConvKeep[i];
+  }
+  UM_ProbeCalibDirty = UM_ProbeCalibDirtyKeep;
+
+  return SUCCESS;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_PROBE_calibGain
+**功能 : Trim the Measured Divider Ratio against a Reference
+**輸入 : channel, step (+-1 = +-1/4096)
+**輸出 : None
+**使用 : UM_PROBE_calibGain(1, 1);  // reading 0.024% higher
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_PROBE_calibGain( uint8_t channel, int8_t step )
+{
+  if((channel == 0) || (channel > UM_PROBE_CONV_NUM))
+    return;
+  channel--;
+
+  UM_ProbeDivider[channel] += step * (UM_ProbeDivider[channel] >> 12);
+  UM_ProbeConv[channel].Gain = (channel == UM_PROBE_CH_DIF - 1) ? ADC_GAIN_DIF(UM_ProbeDivider[channel]) : ADC_GAIN(UM_ProbeDivider[channel]);
+  UM_ProbeCalibDirty = 1;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_PROBE_calibZero
+**功能 : Take the Present Reading as Zero, Input Shorted
+**輸入 : channel, adcData, bits
+**輸出 : None
+**使用 : UM_PROBE_calibZero(1, UM_ProbeICH_getOverADC(1), UM_ProbeICH_getOverBits());  // UM_ProbeICH_getDifADC() for DIF
+**====================================================================================================*/
+/*====================================================================================================*/
+void UM_PROBE_calibZero( uint8_t channel, uint32_t adcData, uint8_t bits )
+{
+  if((channel == 0) || (channel > UM_PROBE_CONV_NUM))
+    return;
 
-uint16_t UM_PROBE_ADCtoVol( uint16_t adcData )
+  UM_ProbeConv[channel - 1].Offset -= UM_PROBE_ADCtoVol(channel, adcData, bits);
+  UM_ProbeCalibDirty = 1;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : UM_PROBE_ADCtoVol
+**功能 : ADC Data with Extra Bits to uV, Gain / Offset, Piecewise Linear and VDDA Correction
+**輸入 : channel, adcData, bits
+**輸出 : uV
+**使用 : tmpData = UM_PROBE_ADCtoVol(1, UM_ProbeICH_getOverADC(1), UM_ProbeICH_getOverBits());
+**====================================================================================================*/
+/*====================================================================================================*/
+int32_t UM_PROBE_ADCtoVol( uint8_t channel, uint32_t adcData, uint8_t bits )
 {
-  return (uint16_t)(adcData * ADC_RESOLUTION + 0.5);
+  const UM_ProbeConv_Struct *pConv = NULL;
+  uint8_t  shift = UM_PROBE_CORR_SHIFT + bits;
+  uint32_t index = adcData >> shift;
+  int32_t  frac  = adcData & ((1UL << shift) - 1);
+  int32_t  corr  = 0;
+  int32_t  vol   = 0;
+  int64_t  code  = adcData;
+
+  if((channel == 0) || (channel > UM_PROBE_CONV_NUM))
+    return 0;
+  pConv = &UM_ProbeConv[channel - 1];
+
+  /* breakpoints every 2^UM_PROBE_CORR_SHIFT counts, no search */
+  if(index >= UM_PROBE_CORR_NUM - 1) {
+    index = UM_PROBE_CORR_NUM - 2;
+    frac  = adcData - (index << shift);
+  }
+  corr = pConv->Corr[index] + (int32_t)(((int64_t)(pConv->Corr[index + 1] - pConv->Corr[index]) * frac) >> shift);
+
+  /* differential counts from mid scale, IN3 - IN4 is CH2 - CH1, negated to read CH1 - CH2 */
+  if(channel == UM_PROBE_CH_DIF)
+    code = ((int64_t)2048 << bits) - adcData;
+
+  vol = (int32_t)((code * pConv->Gain + (1LL << (15 + bits))) >> (16 + bits)) + corr;
+
+  return (int32_t)(((int64_t)vol * UM_ProbeVddaRatio + 0x8000) >> 16) + pConv->Offset;
 }
 /*====================================================================================================*/
 /*====================================================================================================*
+**函數 : UM_PROBE_VolToADC
+**功能 : uV to the Lowest 12-bit ADC Code Reading at Least That, CH1 / CH2
+**輸入 : channel, uV
+**輸出 : adcData
+**使用 : level = UM_PROBE_VolToADC(1, 300000);  // trigger level at 0.3 V
+**====================================================================================================*/
+/*====================================================================================================*/
+uint16_t UM_PROBE_VolToADC( uint8_t channel, int32_t uV )
+{
+  uint16_t code = 0;
+
+  /* the reading rises with the code, 12 steps of a binary search, same gain, table and VDDA */
+  for(uint16_t bit = 1 << 11; bit != 0; bit >>= 1)
+    if(UM_PROBE_ADCtoVol(channel, code + bit - 1, 0) < uV)
+      code += bit;
+
+  return code;
+}
+/*====================================================================================================*
 **函數 : uMultimeter_measure_ADCtoRes
 **功能 : 
 **輸入 : adcData
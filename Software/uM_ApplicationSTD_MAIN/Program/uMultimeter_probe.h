@@ -4,6 +4,9 @@
 #define __UMULTIMETER_PROBE_H
 
 #include "stm32f30x.h"
+#include "algorithms\algorithm_trigger.h"
+#include "algorithms\algorithm_measure.h"
+#include "algorithms\algorithm_peak.h"
 /*====================================================================================================*/
 /*====================================================================================================*/
 #define UM_PROBE_PULSE  TIMx_PWM_PULSE
@@ -11,6 +14,66 @@
 #define UM_PROBE_DUTY   TIMx_PWM_DUTY
 #define UM_PROBE_ON     PWM_MAX
 #define UM_PROBE_OFF    PWM_MIN
+
+#define UM_PROBE_AVE_BITS 10    // 1024 samples
+#define UM_PROBE_AVE_EMA  4     // 1/16 per 16 samples
+#define UM_PROBE_OVS_MAX  6     // 4096 samples, 18-bit result
+#define UM_PROBE_RMS_RATE 10    // AC results per second
+#define UM_PROBE_RMS_BITS 3     // extra bits of the q15 RMS data
+#define UM_PROBE_RING_SIZE  2048  // burst ring, 0.8 ms at ADC_BURST_RATE, a trigger window up to half of it
+#define UM_PROBE_TRIG_WAIT  16    // rings without a trigger per call, 12.7 ms
+#define UM_PROBE_PHASE_NUM  4096  // aligned pairs per phase result
+
+#define UM_PROBE_CONV_NUM   3     // CH1, CH2, DIF
+#define UM_PROBE_CH_DIF     3     // CH1 - CH2, hardware differential
+#define UM_PROBE_CORR_SHIFT 9     // correction breakpoint every 512 counts
+#define UM_PROBE_CORR_NUM   ((4096 >> UM_PROBE_CORR_SHIFT) + 1)
+
+#define UM_CALIB_ADDR       ((uint32_t)0x0801F800)  // last 2 KB page, IROM1 ends here
+#define UM_CALIB_MAGIC      ((uint16_t)0x554D)      // "UM"
+#define UM_CALIB_VERSION    2                       // 2 - DIF conversion added
+
+#define UM_PROBE_ADCtoMilliVol(__CH, __ADC) (UM_PROBE_ADCtoVol((__CH), (__ADC), 0) / 1000)
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  uint16_t CH1;
+  uint16_t CH2;
+} UM_ProbePair_Struct;
+
+typedef struct {
+  uint64_t S11;       // sums over the pairs, 12-bit counts
+  uint64_t S22;
+  uint64_t S12;
+  uint32_t S1;
+  uint32_t S2;
+  uint32_t Num;
+  uint32_t Block;     // block count of the last pairs taken
+  uint16_t Phase;     // 0.1 degree, CH2 against CH1, 0 - 1800, no lead / lag
+} UM_ProbePhase_Struct;
+
+typedef struct {
+  int32_t  Dc;        // uV
+  int32_t  Rms;       // uV, AC part, DC removed
+  uint16_t Crest;     // peak / RMS, x100
+  uint32_t Freq;      // mHz, 0 - no period found
+} UM_ProbeAC_Struct;
+
+typedef struct {
+  int32_t Gain;                       // uV per 12-bit count, Q16, DIF counts from 2048
+  int32_t Offset;                     // uV
+  int32_t Corr[UM_PROBE_CORR_NUM];    // uV, at 0, 512, ... 4096 counts
+} UM_ProbeConv_Struct;
+
+typedef struct {
+  uint16_t Magic;
+  uint16_t Version;
+  uint32_t Size;
+  uint32_t AdcCalib;                            // ADC CALFACT
+  int32_t  Divider[UM_PROBE_CONV_NUM];          // measured (R1 + R2) / R2, Q16
+  UM_ProbeConv_Struct Conv[UM_PROBE_CONV_NUM];
+  uint32_t Crc;                                 // CRC-32 of all fields above
+} UM_ProbeCalib_Struct;
 /*====================================================================================================*/
 /*====================================================================================================*/
 void     UM_PROBE_Config( void );
@@ -23,8 +86,35 @@ uint32_t UM_ProbeOCH_GetFreq( void );
 
 uint16_t UM_ProbeICH_getADC( uint8_t channel );
 uint16_t UM_ProbeICH_getAveADC( uint8_t channel );
+void     UM_ProbeICH_setAverage( uint8_t windowBits, uint8_t emaShift );
+void     UM_ProbeICH_setOverSample( uint8_t bits, FunctionalState jitter );
+uint32_t UM_ProbeICH_getOverADC( uint8_t channel );
+uint8_t  UM_ProbeICH_getOverBits( void );
+void     UM_ProbeICH_setDifferential( FunctionalState state );
+uint32_t UM_ProbeICH_getDifADC( void );
+void     UM_ProbeICH_setRms( uint8_t channel );
+uint32_t UM_ProbeICH_getAC( UM_ProbeAC_Struct *pAC );
+void     UM_ProbeICH_setCapture( uint8_t channel, uint16_t *pBuf, uint16_t lens );
+uint16_t UM_ProbeICH_getCapture( void );
+uint16_t UM_ProbeICH_getVdda( void );
+int16_t  UM_ProbeICH_getTemp( void );
+uint32_t UM_ProbeICH_setSampleRate( uint32_t sampleRate );
+uint32_t UM_ProbeICH_getBlockCount( void );
+uint16_t *UM_ProbeICH_getRing( uint16_t lens );
+uint8_t  UM_ProbeICH_getTrigger( uint8_t channel, Trig_Struct *pTrig, Peak_Struct *pPeak, uint16_t depth );
+uint32_t UM_ProbeICH_getMeasure( Meas_Struct *pMeas );
+uint16_t UM_ProbeICH_getPairs( UM_ProbePair_Struct *pPair );
+void     UM_ProbeICH_initPhase( UM_ProbePhase_Struct *pPhase );
+uint32_t UM_ProbeICH_getPhase( UM_ProbePhase_Struct *pPhase );
 
-uint16_t UM_PROBE_ADCtoVol( uint16_t adcData );
+ErrorStatus UM_PROBE_loadCalib( void );
+ErrorStatus UM_PROBE_saveCalib( void );
+void     UM_PROBE_calibStart( void );
+ErrorStatus UM_PROBE_calibEnd( FunctionalState save );
+void     UM_PROBE_calibGain( uint8_t channel, int8_t step );
+void     UM_PROBE_calibZero( uint8_t channel, uint32_t adcData, uint8_t bits );
+int32_t  UM_PROBE_ADCtoVol( uint8_t channel, uint32_t adcData, uint8_t bits );
+uint16_t UM_PROBE_VolToADC( uint8_t channel, int32_t uV );
 
 void UM_EXPAND_modeInit( uint32_t mode );
 void UM_EXPAND_modeVol( uint32_t mode );
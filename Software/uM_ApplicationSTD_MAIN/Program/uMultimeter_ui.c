@@ -4,13 +4,16 @@
 
 #include "uMultimeter.h"
 #include "uMultimeter_ui.h"
+#include "applications\app_widget.h"
+#include "algorithms\algorithm_fft.h"
+#include "algorithms\algorithm_trigger.h"
 /*====================================================================================================*/
 /*====================================================================================================*/
-#define UI_PutChar      OLED_PutChar
-#define UI_PutChar16    OLED_PutChar16
-#define UI_PutChar32    OLED_PutChar32
-#define UI_DrawRect     OLED_DrawRect
-#define UI_DrawRectFill OLED_DrawRectFill
+#define UI_PutChar      WidgetPutChar     // retained, only changed cells reach the OLED
+#define UI_PutChar16    WidgetPutChar16
+#define UI_PutChar32    WidgetPutChar32
+#define UI_DrawRect     WidgetDrawRect
+#define UI_DrawRectFill WidgetDrawRectFill
 /*====================================================================================================*/
 /*====================================================================================================*
 **函數 : getNumDigit
@@ -37,7 +40,7 @@ uint8_t getNumDigit( uint8_t *numBuf, uint32_t newNum )
 #define SEL_WINDOW_X (0)
 #define SEL_WINDOW_Y (OLED_H - 1 - 8)
 
-const uint16_t fontMatrix_5x16[12][5] = {
+const uint16_t fontMatrix_5x16[14][5] = {
   {0x4990, 0x4A50, 0x4A50, 0x4A50, 0x319E}, // VOL, 0
   {0x7BCE, 0x4A10, 0x7B8C, 0x5202, 0x4BDC}, // RES, 1
   {0xF45B, 0x9455, 0xF555, 0x8551, 0x8291}, // PWM, 2
@@ -51,6 +54,8 @@ const uint16_t fontMatrix_5x16[12][5] = {
   {0x39DE, 0x2490, 0x249C, 0x2490, 0x39D0}, // DIF, 9
   {0x39CC, 0x2492, 0x2492, 0x2492, 0x39CC}, // DIO, 10
   {0x1910, 0x2510, 0x2510, 0x3D10, 0x25DC}, // ALL, 11
+  {0x0C70, 0x1280, 0x1E80, 0x1280, 0x1270}, // AC,  12
+  {0x3DEE, 0x2104, 0x39C4, 0x2104, 0x2104}, // FFT, 13
 };
 
 void UM_UI_menuDisplay_button( uint8_t posX, uint8_t posY, uint8_t select, uint16_t fontColor, uint16_t backColor )
@@ -69,8 +74,10 @@ void UM_UI_menuDisplay( uint32_t mode )
         UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*0, SEL_WINDOW_Y + 1, 7, WHITE, BLACK);
       else if(tmpModeS == MODE_VOL_CH2)
         UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*0, SEL_WINDOW_Y + 1, 8, WHITE, BLACK);
-      else
+      else if(tmpModeS == MODE_VOL_DIF)
         UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*0, SEL_WINDOW_Y + 1, 9, WHITE, BLACK);
+      else
+        UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*0, SEL_WINDOW_Y + 1, 12, WHITE, BLACK);
       UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*1, SEL_WINDOW_Y + 1, 1, BLACK, WHITE);
       UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*2, SEL_WINDOW_Y + 1, 2, BLACK, WHITE);
       UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*3, SEL_WINDOW_Y + 1, 3, BLACK, WHITE);
@@ -106,6 +113,8 @@ void UM_UI_menuDisplay( uint32_t mode )
         UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*3, SEL_WINDOW_Y + 1, 8, WHITE, BLACK);
       else if(tmpModeS == MODE_WAV_ALL)
         UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*3, SEL_WINDOW_Y + 1, 11, WHITE, BLACK);
+      else if(tmpModeS == MODE_WAV_FFT)
+        UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*3, SEL_WINDOW_Y + 1, 13, WHITE, BLACK);
       else
         UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*3, SEL_WINDOW_Y + 1, 4, WHITE, BLACK);
       UM_UI_menuDisplay_button(SEL_WINDOW_X + 1 + 19*4, SEL_WINDOW_Y + 1, 4, BLACK, WHITE);
@@ -125,19 +134,25 @@ void UM_UI_menuDisplay( uint32_t mode )
 /*====================================================================================================*/
 const uint16_t UI_charArray_V5x16_CH1[5] = {0x3A58,0x4249,0x43C8,0x4249,0x3A5C}; // CH1:
 const uint16_t UI_charArray_V5x16_CH2[5] = {0x3A5C,0x4245,0x43DC,0x4251,0x3A5C}; // CH2:
+const uint16_t UI_charArray_V5x16_HZ[5]  = {0x4BC0,0x4841,0x7880,0x4901,0x4BC0}; // Hz:
+const uint16_t UI_charArray_V5x16_CF[5]  = {0x3BC0,0x4201,0x4380,0x4201,0x3A00}; // CF:
+const uint16_t UI_charArray_V5x16_VDD[5] = {0x5660,0x5551,0x5550,0x5551,0x2660}; // VDD:
+const uint16_t UI_charArray_V5x16_TMP[5] = {0x7560,0x2751,0x2560,0x2541,0x2540}; // TMP:
+const uint16_t UI_charArray_V5x16_PHS[5] = {0x6530,0x5541,0x6720,0x4511,0x4560}; // PHS:
 const uint16_t UI_charArray_V5x9_DC[5]   = {0x01C7,0x0128,0x0128,0x0128,0x01C7}; // DC
 const uint16_t UI_charArray_V5x9_AC[5]   = {0x00C7,0x0128,0x0128,0x01E8,0x0127}; // AC
 const uint16_t UI_charArray_V16x16_m[22] = {0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xCE3C,0xFF7E,0xE3C7,0xC183,0xC183,0xC183,0xC183,0xC183,0xC183,0xC183,0xC183};  // 16x16 m
 const uint16_t UI_charArray_V16x16_V[22] = {0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xE01C,0xE01C,0x6038,0x7038,0x7030,0x3070,0x3870,0x3860,0x18E0,0x18E0,0x1CC0,0x0DC0,0x0D80,0x0D80,0x0780,0x0700};  // 16x16 V
+const uint16_t UI_charArray_V16x5_dot[22] = {0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x000C,0x001E,0x001E,0x000C};  // 16x5 .
 
-void UM_UI_modeVOL_putNum5x3( uint8_t posX, uint8_t posY, uint16_t number, uint16_t fontColor, uint16_t backColor )
+void UM_UI_modeVOL_putNum5x3( uint8_t posX, uint8_t posY, uint32_t number, uint16_t fontColor, uint16_t backColor )
 {
-  uint8_t num[4] = {0};
+  uint8_t num[5] = {0};
 
   getNumDigit(num, number);
 
-  for(int8_t i = 0; i < 4; i++)
-    UI_PutChar(posX + i*4, posY, 5, 4, ASCII_NUM_5x3[num[3 - i]], fontColor, backColor);
+  for(int8_t i = 0; i < 5; i++)
+    UI_PutChar(posX + i*4, posY, 5, 4, ASCII_NUM_5x3[num[4 - i]], fontColor, backColor);
 }
 void UM_UI_modeVOL_putBigNum16x16( uint8_t posX, uint8_t posY, uint16_t number, uint16_t fontColor, uint16_t backColor )
 {
@@ -180,6 +195,45 @@ void UM_UI_modeVOL_putBigNum16x16( uint8_t posX, uint8_t posY, uint16_t number,
     UI_PutChar16(posX + 72, posY, 22, 16, UI_charArray_V16x16_V, fontColor, backColor);
   }
 }
+void UM_UI_modeVOL_putVolNum16x16( uint8_t posX, uint8_t posY, uint32_t number, uint8_t bits, uint16_t fontColor, uint16_t backColor )
+{
+  static uint8_t layout = 0;
+  uint8_t num[4] = {0};
+  uint8_t dotPos = 0;
+
+  /* 1 mV digit only when the extra bits resolve it, narrow dot makes room for it */
+  if((bits < 2) || (number < 999500) || (number >= 99995000))
+    dotPos = 0;
+  else if(number < 9999500)
+    dotPos = 1;   // d.ddd V
+  else
+    dotPos = 2;   // dd.dd V
+
+  /* the two grids do not line up, clear the gaps in between */
+  if(layout != dotPos) {
+    if((layout != 0) || (dotPos != 0))
+      UI_DrawRectFill(posX, posY, 89, 22, backColor);
+    layout = dotPos;
+  }
+
+  if(dotPos == 0) {
+    UM_UI_modeVOL_putBigNum16x16(posX, posY, (number + 500) / 1000, fontColor, backColor);
+    return;
+  }
+  if(dotPos == 1)
+    getNumDigit(num, (number + 500) / 1000);
+  else
+    getNumDigit(num, (number + 5000) / 10000);
+
+  for(uint8_t i = 0, x = posX; i < 4; i++, x += 17) {
+    if(i == dotPos) {
+      UI_PutChar16(x, posY, 22, 5, UI_charArray_V16x5_dot, fontColor, backColor);
+      x += 5;
+    }
+    UI_PutChar16(x, posY, 22, 16, ASCII_NUM_22x16[num[3 - i]], fontColor, backColor);
+  }
+  UI_PutChar16(posX + 73, posY, 22, 16, UI_charArray_V16x16_V, fontColor, backColor);
+}
 
 #define MODE_VOL_CH1_X    (0)
 #define MODE_VOL_CH1_Y    (0)
@@ -193,6 +247,20 @@ void UM_UI_modeVOL_putBigNum16x16( uint8_t posX, uint8_t posY, uint16_t number,
 #define MODE_VOL_DCAC_Y   (MODE_VOL_CH1_Y)
 #define MODE_VOL_BIGN_X   (7)
 #define MODE_VOL_BIGN_Y   (22)
+#define MODE_VOL_SIGN_X   (0)
+#define MODE_VOL_SIGN_Y   (MODE_VOL_BIGN_Y + 12)
+#define MODE_VOL_BAR_X    (MODE_VOL_BIGN_X)
+#define MODE_VOL_BAR_Y    (48)
+#define MODE_VOL_BAR_W    (88)
+#define MODE_VOL_BAR_H    (3)
+#define MODE_VOL_BAR_FULL (28050000)  // uV, ADC full scale
+#define MODE_VOL_CALB_X   (MODE_VOL_BIGN_X)
+#define MODE_VOL_CALB_Y   (11)
+#define MODE_VOL_STAT_Y   (MODE_VOL_CALB_Y + 1)
+
+static uint8_t modeVOL_Calib = 0;   // the calibration line holds the status row
+
+WidgetBar_Struct modeVOL_Bar = {MODE_VOL_BAR_X, MODE_VOL_BAR_Y, MODE_VOL_BAR_W, MODE_VOL_BAR_H, MODE_VOL_BAR_FULL, GREEN, BLACK, 0};
 void UM_UI_modeVOL_setMode( uint8_t mode )
 {
   if(!mode) UI_PutChar16(MODE_VOL_DCAC_X, MODE_VOL_DCAC_Y, 5, 9, UI_charArray_V5x9_DC, WHITE, BLACK);
@@ -200,29 +268,69 @@ void UM_UI_modeVOL_setMode( uint8_t mode )
 }
 void UM_UI_modeVOL_Init( uint8_t mode )
 {
+  modeVOL_Calib = 0;
+  WidgetInvalidate(0, 0, OLED_W, OLED_H - 9);
   UI_DrawRectFill(0, 0, OLED_W, OLED_H - 9, BLACK);
-  UI_PutChar16(MODE_VOL_CH1_X, MODE_VOL_CH1_Y, 5, 16, UI_charArray_V5x16_CH1, GREEN, BLACK);
-  UI_PutChar16(MODE_VOL_CH2_X, MODE_VOL_CH2_Y, 5, 16, UI_charArray_V5x16_CH2,  BLUE, BLACK);
-  UM_UI_modeVOL_setMode(0);
-  UM_UI_modeVOL(0, 0, 0);
+  if(mode == MODE_VOL_AC) {   // frequency, crest factor x100
+    UI_PutChar16(MODE_VOL_CH1_X, MODE_VOL_CH1_Y, 5, 16, UI_charArray_V5x16_HZ, GREEN, BLACK);
+    UI_PutChar16(MODE_VOL_CH2_X, MODE_VOL_CH2_Y, 5, 16, UI_charArray_V5x16_CF,  BLUE, BLACK);
+  }
+  else {
+    UI_PutChar16(MODE_VOL_CH1_X, MODE_VOL_CH1_Y, 5, 16, UI_charArray_V5x16_CH1, GREEN, BLACK);
+    UI_PutChar16(MODE_VOL_CH2_X, MODE_VOL_CH2_Y, 5, 16, UI_charArray_V5x16_CH2,  BLUE, BLACK);
+  }
+  UM_UI_modeVOL_setMode(mode == MODE_VOL_AC);
+  UM_UI_modeVOL(0, 0, 0, 0);
+}
+static void UM_UI_modeVOL_putStat( uint16_t vdda, const uint16_t *pLabel, uint32_t number )
+{
+  if(modeVOL_Calib)
+    return;
+  UI_PutChar16(MODE_VOL_CH1_X, MODE_VOL_STAT_Y, 5, 16, UI_charArray_V5x16_VDD, GRAY, BLACK);
+  UM_UI_modeVOL_putNum5x3(MODE_VOL_NUM1_X, MODE_VOL_STAT_Y, vdda, GRAY, BLACK);
+  UI_PutChar16(MODE_VOL_CH2_X, MODE_VOL_STAT_Y, 5, 16, pLabel, GRAY, BLACK);
+  UM_UI_modeVOL_putNum5x3(MODE_VOL_NUM2_X, MODE_VOL_STAT_Y, number, GRAY, BLACK);
+}
+void UM_UI_modeVOL_putStatus( uint16_t vdda, int16_t temp )
+{
+  UM_UI_modeVOL_putStat(vdda, UI_charArray_V5x16_TMP, (temp > 0) ? temp : 0);
 }
-void UM_UI_modeVOL( uint16_t number_ch1, uint16_t number_ch2, uint16_t number )
+void UM_UI_modeVOL_putPhase( uint16_t vdda, uint16_t phase )
 {
-  static uint16_t tmpData = 0;
-  uint16_t deltaData = 0;
+  UM_UI_modeVOL_putStat(vdda, UI_charArray_V5x16_PHS, phase);
+}
+void UM_UI_modeVOL_putCalib( uint8_t state, int16_t trim )
+{
+  /* the reading below is set against the reference, trim in 1/4096 steps */
+  modeVOL_Calib = state;
+  WidgetInvalidate(0, MODE_VOL_CALB_Y, OLED_W, 8);
+  OLED_DrawRectFill(0, MODE_VOL_CALB_Y, OLED_W, 8, BLACK);   // drawn without widget, the status cells come back
+  if(!state)
+    return;
+  OLED_PutStr_5x7(MODE_VOL_CALB_X, MODE_VOL_CALB_Y, "CAL", RED, BLACK);
+  OLED_PutNum(MODE_VOL_CALB_X + 24, MODE_VOL_CALB_Y, Type_I, 4, trim, WHITE, BLACK);
+  OLED_PutStr_5x7(MODE_VOL_CALB_X + 60, MODE_VOL_CALB_Y, "P:OK", YELLOW, BLACK);
+}
+void UM_UI_modeVOL( uint32_t number_ch1, uint32_t number_ch2, int32_t number, uint8_t bits )
+{
+  static int32_t tmpData = 0;
+  uint32_t deltaData = 0;
+  uint32_t absData = (number < 0) ? -number : number;
 
   UM_UI_modeVOL_putNum5x3(MODE_VOL_NUM1_X, MODE_VOL_NUM1_Y, number_ch1, WHITE, BLACK);
   UM_UI_modeVOL_putNum5x3(MODE_VOL_NUM2_X, MODE_VOL_NUM2_Y, number_ch2, WHITE, BLACK);
 
   deltaData = (number > tmpData) ? number - tmpData : tmpData - number;
-  if(deltaData > 40) {  // delat > 40 mV
+  if(deltaData > 40000) {  // delat > 40 mV
     UI_DrawRectFill(MODE_VOL_DCAC_X + 12, MODE_VOL_DCAC_Y, 2, 5, RED);
     tmpData = number;
   }
   else
     UI_DrawRectFill(MODE_VOL_DCAC_X + 12, MODE_VOL_DCAC_Y, 2, 5, BLACK);
 
-  UM_UI_modeVOL_putBigNum16x16(MODE_VOL_BIGN_X, MODE_VOL_BIGN_Y, number, WHITE, BLACK);
+  UI_DrawRectFill(MODE_VOL_SIGN_X, MODE_VOL_SIGN_Y, 6, 2, (number < 0) ? WHITE : BLACK);   // DIF only
+  UM_UI_modeVOL_putVolNum16x16(MODE_VOL_BIGN_X, MODE_VOL_BIGN_Y, absData, bits, WHITE, BLACK);
+  WidgetBar(&modeVOL_Bar, absData);
 }
 /*====================================================================================================*/
 /*====================================================================================================*/
@@ -331,6 +439,7 @@ void UM_UI_modeRES_setMode( uint8_t mode )
 }
 void UM_UI_modeRES_Init( uint8_t mode )
 {
+  WidgetInvalidate(0, 0, OLED_W, OLED_H - 9);
   UI_DrawRectFill(0, 0, OLED_W, OLED_H - 9, BLACK);
   UI_PutChar32(MODE_RES_CODE_X, MODE_RES_CODE_Y, 5, 21, UI_charArray_R5x21_CODE, WHITE, BLACK);
 
@@ -434,11 +543,11 @@ void UM_UI_modePWM_putPLUSE( uint8_t posX, uint8_t posY, uint16_t duty, uint16_t
   }
   else if(newDuty > oldDuty) {
     UI_DrawRect(posX + WAVE_X_W + oldDuty - 2, posY, newDuty - oldDuty + 1, WAVE_H, backColor);
-    UI_DrawRectFill(posX + WAVE_X_W + oldDuty - 1, posY, newDuty - oldDuty - 1, WAVE_X_H, backColor);
+    UI_DrawRectFill(posX + WAVE_X_W + oldDuty - 1, posY + WAVE_H - WAVE_X_H, newDuty - oldDuty - 1, WAVE_X_H, backColor);
   }
   else {
     UI_DrawRect(posX + WAVE_X_W + newDuty - 2, posY, oldDuty - newDuty + 1, WAVE_H, backColor);
-    UI_DrawRectFill(posX + WAVE_X_W + newDuty - 1, posY + WAVE_H - WAVE_X_H, oldDuty - newDuty - 1, WAVE_X_H, backColor);
+    UI_DrawRectFill(posX + WAVE_X_W + newDuty - 1, posY, oldDuty - newDuty - 1, WAVE_X_H, backColor);
   }
 
   UI_DrawRectFill(posX,                          posY + WAVE_H - WAVE_X_H, WAVE_X_W,             WAVE_X_H, LineColor);
@@ -446,9 +555,10 @@ void UM_UI_modePWM_putPLUSE( uint8_t posX, uint8_t posY, uint16_t duty, uint16_t
   UI_DrawRectFill(posX + WAVE_X_W + newDuty - 2, posY + WAVE_H - WAVE_X_H, WAVE_W - newDuty + 1, WAVE_X_H, LineColor);
   UI_DrawRectFill(posX + WAVE_X_W + WAVE_W - 2,  posY,                     WAVE_X_W,             WAVE_X_H, LineColor);
 
-  OLED_DrawLineY(posX + WAVE_X_W - 1,           posY, WAVE_H, LineColor);
-  OLED_DrawLineY(posX + WAVE_X_W + newDuty - 2, posY, WAVE_H, LineColor);
-  OLED_DrawLineY(posX + WAVE_X_W + WAVE_W - 2,  posY, WAVE_H, LineColor);
+  /* edges between the levels, cells that overlap would knock each other out of the widget table */
+  UI_DrawRectFill(posX + WAVE_X_W - 1,           posY + WAVE_X_H, 1, WAVE_H - 2 * WAVE_X_H, LineColor);
+  UI_DrawRectFill(posX + WAVE_X_W + newDuty - 2, posY + WAVE_X_H, 1, WAVE_H - 2 * WAVE_X_H, LineColor);
+  UI_DrawRectFill(posX + WAVE_X_W + WAVE_W - 2,  posY + WAVE_X_H, 1, WAVE_H - 2 * WAVE_X_H, LineColor);
 
   oldDuty = newDuty;
 }
@@ -465,6 +575,7 @@ void UM_UI_modePWM_putPLUSE( uint8_t posX, uint8_t posY, uint16_t duty, uint16_t
 #define MODE_PWM_PLUSE_Y  (15)
 void UM_UI_modePWM_Init( uint8_t mode )
 {
+  WidgetInvalidate(0, 0, OLED_W, OLED_H - 9);
   UI_DrawRectFill(0, 0, OLED_W, OLED_H - 9, BLACK);
   UI_PutChar(MODE_PWM_DUTY_X, MODE_PWM_DUTY_Y, 5, 6, UI_charArray_P5x6_D, WHITE, BLACK);
   UI_PutChar(MODE_PWM_DUTY_X + 31, MODE_PWM_DUTY_Y, 5, 6, UI_charArray_P5x6_P, WHITE, BLACK);
@@ -497,37 +608,99 @@ void UM_UI_modeWAV_putNum5x3( uint8_t posX, uint8_t posY, int16_t number, uint16
     UI_PutChar(posX + i*4 + 4, posY, 5, 4, ASCII_NUM_5x3[num[3 - i]], fontColor, backColor);
 }
 
+void UM_UI_modeWAV_putFix5x3( uint8_t posX, uint8_t posY, int32_t number, uint16_t fontColor, uint16_t backColor )
+{
+  uint8_t  num[4] = {0};
+  uint8_t  point = 3;
+  uint8_t  cells = 5;
+  uint32_t full = 9999;
+  uint32_t data = (number < 0) ? -number : number;
+
+  /* a minus takes the first cell and one digit */
+  if(number < 0) {
+    UI_PutChar(posX, posY, 5, 4, ASCII_NUM_5x3[12], fontColor, backColor);
+    posX += 4;
+    cells = 4;
+    full = 999;
+  }
+
+  /* number has 3 decimals, the digits that fit are kept and the point moves right as it grows */
+  while((data > full) && (point > 0)) {
+    data /= 10;
+    point--;
+  }
+  if(data > full)
+    data = full;
+  getNumDigit(num, data);
+
+  for(int8_t i = 0, j = cells - 2; i < cells; i++) {
+    if(i == cells - 1 - point)
+      UI_PutChar(posX + i*4, posY, 5, 4, ASCII_NUM_5x3[10], fontColor, backColor);
+    else
+      UI_PutChar(posX + i*4, posY, 5, 4, ASCII_NUM_5x3[num[j--]], fontColor, backColor);
+  }
+}
+
 #define MODE_WAV_CH1_X   (2)
 #define MODE_WAV_CH1_Y   (1)
 #define MODE_WAV_CH2_X   (50)
 #define MODE_WAV_CH2_Y   (MODE_WAV_CH1_Y)
 
+const uint16_t UI_charArray_W5x16_Meas[MEAS_WAV_NUM][5] = {
+  {0x2928,0x3AA8,0x3B90,0x2AA8,0x2AA8}, // MAX
+  {0x2BB0,0x3928,0x3928,0x2928,0x2BA8}, // MIN
+  {0x1298,0x2AA0,0x3AA8,0x2AA8,0x2918}, // AVG
+  {0x3298,0x2BA0,0x3390,0x2A88,0x2AB0}, // RMS
+  {0x2AB8,0x2A88,0x3390,0x2AA0,0x2AB8}, // KHZ
+  {0xCAEA,0xAA4A,0xAA44,0xAA44,0xCE44}, // DUTY
+  {0xCE6E,0xA488,0xC44E,0xA428,0xAECE}, // RISE
+  {0xE488,0x8A88,0xEE88,0x8A88,0x8AEE}, // FALL
+};
+
+static void UM_UI_modeWAV_putMeas( uint8_t posX, uint8_t posY, uint8_t meas, int32_t number, uint16_t color )
+{
+  UI_PutChar16(posX, posY, 5, 16, UI_charArray_W5x16_Meas[meas], BLACK, color);
+  if(meas <= MEAS_WAV_RMS)   // mV in V, 28 V full scale needs the moving point
+    UM_UI_modeWAV_putFix5x3(posX + 18, posY, number, BLACK, WHITE);
+  else
+    UM_UI_modeWAV_putFix5x3(posX + 18, posY, (number > 0) ? number : 0, BLACK, WHITE);
+}
+
 void UM_UI_modeWAV_Init( uint8_t mode )
 {
+  WidgetInvalidate(0, 0, OLED_W, OLED_H - 9);
   UI_DrawRectFill(0, 0, OLED_W, OLED_H - 9, BLACK);
   UI_DrawRectFill(0, 0, 96, 6, WHITE);
   UI_DrawRectFill(MODE_WAV_CH1_X, MODE_WAV_CH1_Y, 16, 5, GREEN);
-  UI_DrawRectFill(MODE_WAV_CH2_X, MODE_WAV_CH1_Y, 16, 5, BLUE);
+  UI_DrawRectFill(MODE_WAV_CH2_X, MODE_WAV_CH1_Y, 16, 5, (mode == MODE_WAV_FFT) ? RED : BLUE);
 }
-void UM_UI_modeWAV_CH1( WaveForm_Struct *pWaveForm )
-{
-  UM_UI_modeWAV_putNum5x3(MODE_WAV_CH1_X + 18, MODE_WAV_CH1_Y, pWaveForm->Data[0], BLACK, WHITE);
-  UM_UI_modeWAV_putNum5x3(MODE_WAV_CH2_X + 18, MODE_WAV_CH1_Y, pWaveForm->Data[1], BLACK, WHITE);
+/* trigger mark, yellow - triggered, gray - free running, red - waiting or single shot held */
+static const uint16_t UI_trigColor[] = {RED, YELLOW, GRAY, RED};
 
-  pWaveForm->PointColor[0] = BLACK;
-  pWaveForm->PointColor[1] = GREEN;
-  pWaveForm->Data[1] = pWaveForm->Data[0];
-  WaveFormPrint(pWaveForm, ENABLE);
+void UM_UI_modeWAV_CH1( WaveForm_Struct *pWaveForm, const int16_t *pHigh, const int16_t *pLow, const int32_t *pMeas, uint8_t page, int16_t trigLevel, uint8_t trigState )
+{
+  page = (page % (MEAS_WAV_NUM / 2)) * 2;
+  UM_UI_modeWAV_putMeas(MODE_WAV_CH1_X, MODE_WAV_CH1_Y, page, pMeas[page], GREEN);
+  UM_UI_modeWAV_putMeas(MODE_WAV_CH2_X, MODE_WAV_CH2_Y, page + 1, pMeas[page + 1], GREEN);
+
+  /* a frame only when there are new columns, a new trigger or a new zoom, otherwise the last frame stays */
+  if(pHigh != NULL) {
+    pWaveForm->PointColor[1] = GREEN;
+    WaveFormPrintSpan(pWaveForm, 1, pHigh, pLow);
+  }
+  WaveFormPrintMark(pWaveForm, 1, trigLevel, UI_trigColor[trigState]);
 }
-void UM_UI_modeWAV_CH2( WaveForm_Struct *pWaveForm )
+void UM_UI_modeWAV_CH2( WaveForm_Struct *pWaveForm, const int16_t *pHigh, const int16_t *pLow, const int32_t *pMeas, uint8_t page, int16_t trigLevel, uint8_t trigState )
 {
-  UM_UI_modeWAV_putNum5x3(MODE_WAV_CH1_X + 18, MODE_WAV_CH1_Y, pWaveForm->Data[0], BLACK, WHITE);
-  UM_UI_modeWAV_putNum5x3(MODE_WAV_CH2_X + 18, MODE_WAV_CH1_Y, pWaveForm->Data[1], BLACK, WHITE);
+  page = (page % (MEAS_WAV_NUM / 2)) * 2;
+  UM_UI_modeWAV_putMeas(MODE_WAV_CH1_X, MODE_WAV_CH1_Y, page, pMeas[page], BLUE);
+  UM_UI_modeWAV_putMeas(MODE_WAV_CH2_X, MODE_WAV_CH2_Y, page + 1, pMeas[page + 1], BLUE);
 
-  pWaveForm->PointColor[0] = BLACK;
-  pWaveForm->PointColor[1] = BLUE;
-  pWaveForm->Data[0] = pWaveForm->Data[1];
-  WaveFormPrint(pWaveForm, ENABLE);
+  if(pHigh != NULL) {
+    pWaveForm->PointColor[1] = BLUE;
+    WaveFormPrintSpan(pWaveForm, 1, pHigh, pLow);
+  }
+  WaveFormPrintMark(pWaveForm, 1, trigLevel, UI_trigColor[trigState]);
 }
 void UM_UI_modeWAV_ALL( WaveForm_Struct *pWaveForm )
 {
@@ -538,6 +711,21 @@ void UM_UI_modeWAV_ALL( WaveForm_Struct *pWaveForm )
   pWaveForm->PointColor[1] = BLUE;
   WaveFormPrint(pWaveForm, ENABLE);
 }
+void UM_UI_modeWAV_FFT( WaveForm_Struct *pWaveForm, const uint16_t *pLog, uint8_t mark, uint32_t freq )
+{
+  uint8_t bar[WaveBarW] = {0};
+
+  for(uint8_t i = 0; i < WaveBarW; i++)
+    bar[i] = (pLog[i] >= FFT_LOG_FULL) ? WaveBarH : (uint32_t)pLog[i] * WaveBarH / FFT_LOG_FULL;
+
+  /* peak frequency in Hz, peak level in dB below a full scale sine */
+  UM_UI_modeVOL_putNum5x3(MODE_WAV_CH1_X + 18, MODE_WAV_CH1_Y, (freq > 99999) ? 99999 : freq, BLACK, WHITE);
+  UM_UI_modeWAV_putNum5x3(MODE_WAV_CH2_X + 18, MODE_WAV_CH1_Y, FFT_LOG_TO_DB((int32_t)pLog[mark] - FFT_LOG_FULL), BLACK, WHITE);
+
+  pWaveForm->PointColor[0] = GREEN;
+  pWaveForm->PointColor[1] = RED;
+  WaveFormPrintBar(pWaveForm, bar, mark);
+}
 /*====================================================================================================*/
 /*====================================================================================================*/
 #define MODE_EXP_X  (4)
@@ -545,6 +733,7 @@ void UM_UI_modeWAV_ALL( WaveForm_Struct *pWaveForm )
 
 void UM_UI_modeEXP_Init( uint8_t mode )
 {
+  WidgetInvalidate(0, 0, OLED_W, OLED_H - 9);
   UI_DrawRectFill(0, 0, OLED_W, OLED_H - 9, BLACK);
   UI_DrawRectFill(0, 0, 11, 11, GREEN);
   UI_DrawRectFill(14, 0, 5, 11, BLUE);
@@ -24,6 +24,7 @@ typedef enum {
   MODE_VOL_CH1 =  0,
   MODE_VOL_CH2,
   MODE_VOL_DIF,
+  MODE_VOL_AC,
   MODE_VOL_MAX,
   MODE_VOL_DEBUG,
 } uM_modeVOL;
@@ -49,11 +50,24 @@ typedef enum {
   MODE_WAV_CH1 =  0,
   MODE_WAV_CH2,
   MODE_WAV_ALL,
+  MODE_WAV_FFT,
   MODE_WAV_EXP,
   MODE_WAV_MAX,
   MODE_WAV_DEBUG,
 } uM_modeWAV;
 
+typedef enum {
+  MEAS_WAV_MAX = 0,     // mV
+  MEAS_WAV_MIN,
+  MEAS_WAV_AVG,
+  MEAS_WAV_RMS,
+  MEAS_WAV_FREQ,        // Hz, shown in kHz
+  MEAS_WAV_DUTY,        // 0.001 %
+  MEAS_WAV_RISE,        // ns, shown in us
+  MEAS_WAV_FALL,
+  MEAS_WAV_NUM,
+} uM_measWAV;
+
 typedef enum {
   MODE_EXP_MIN = -1,
   MODE_EXP_NUL =  0,
@@ -91,7 +105,10 @@ struct menuPage_st{
 void UM_UI_menuDisplay( uint32_t mode );
   
 void UM_UI_modeVOL_Init( uint8_t mode );
-void UM_UI_modeVOL( uint16_t number_ch1, uint16_t number_ch2, uint16_t number );
+void UM_UI_modeVOL_putStatus( uint16_t vdda, int16_t temp );   // mV, 0.1 C
+void UM_UI_modeVOL_putPhase( uint16_t vdda, uint16_t phase );  // mV, 0.1 degree CH2 against CH1, AC in place of the temperature
+void UM_UI_modeVOL_putCalib( uint8_t state, int16_t trim );  // 0 clears the calibration line
+void UM_UI_modeVOL( uint32_t number_ch1, uint32_t number_ch2, int32_t number, uint8_t bits );   // number in uV, signed for DIF, ch1 / ch2 ADC with bits extra bits
 
 void UM_UI_modeRES_Init( uint8_t mode );
 void UM_UI_modeRES_RES( uint32_t number, uint8_t beepState );
@@ -101,9 +118,10 @@ void UM_UI_modePWM_Init( uint8_t mode );
 void UM_UI_modePWM( uint16_t duty, uint32_t freq );
 
 void UM_UI_modeWAV_Init( uint8_t mode );
-void UM_UI_modeWAV_CH1( WaveForm_Struct *pWaveForm );
-void UM_UI_modeWAV_CH2( WaveForm_Struct *pWaveForm );
+void UM_UI_modeWAV_CH1( WaveForm_Struct *pWaveForm, const int16_t *pHigh, const int16_t *pLow, const int32_t *pMeas, uint8_t page, int16_t trigLevel, uint8_t trigState );   // max / min mV per column, NULL - keep the frame, pMeas[MEAS_WAV_NUM], page 0 - 3 shows two of them, trigLevel in mV
+void UM_UI_modeWAV_CH2( WaveForm_Struct *pWaveForm, const int16_t *pHigh, const int16_t *pLow, const int32_t *pMeas, uint8_t page, int16_t trigLevel, uint8_t trigState );
 void UM_UI_modeWAV_ALL( WaveForm_Struct *pWaveForm );
+void UM_UI_modeWAV_FFT( WaveForm_Struct *pWaveForm, const uint16_t *pLog, uint8_t mark, uint32_t freq );   // log2 power Q8 per column, mark - peak column, freq in Hz
 
 void UM_UI_modeEXP_Init( uint8_t mode );
 //void UM_UI_modeEXP( );
@@ -22,7 +22,7 @@ del JLinkLog.txt /s
 
 del *.iex /s
 del *.htm /s
-del *.sct /s
+del Obj\*.sct /s
 del *.hex /s
 del *.map /s
 del JLinkSettings.ini /s
@@ -0,0 +1,145 @@
+/* #include "arm_math.h" */
+
+#ifndef __SIM_ARM_MATH_H
+#define __SIM_ARM_MATH_H
+
+/* real CMSIS header, types & _SIMD32_OFFSET, its own inline helpers cast pointers to 32 bits */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpointer-to-int-cast"
+#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
+#include_next "arm_math.h"
+#pragma GCC diagnostic pop
+/*====================================================================================================*/
+/*====================================================================================================*/
+/* the CMSIS intrinsics are Cortex-M4 inline asm, the algorithms get these C versions instead,
+   GE is kept per file as the core does, set by USUB16 / SSUB16 / UADD16 and read by SEL */
+static uint32_t SIM_GE = 0;
+
+static inline int32_t SIM_SAT16( int32_t x )
+{
+  return (x > 32767) ? 32767 : (x < -32768) ? -32768 : x;
+}
+static inline uint32_t SIM_PACK16( int32_t lo, int32_t hi )
+{
+  return ((uint32_t)lo & 0xFFFF) | ((uint32_t)hi << 16);
+}
+#define SIM_LO(__X)   ((int32_t)(int16_t)(__X))
+#define SIM_HI(__X)   ((int32_t)(int16_t)((__X) >> 16))
+#define SIM_ULO(__X)  ((uint32_t)(__X) & 0xFFFF)
+#define SIM_UHI(__X)  ((uint32_t)(__X) >> 16)
+
+static inline int32_t SIM_SMUSD( uint32_t a, uint32_t b )
+{
+  return SIM_LO(a) * SIM_LO(b) - SIM_HI(a) * SIM_HI(b);
+}
+static inline int32_t SIM_SMUADX( uint32_t a, uint32_t b )
+{
+  return SIM_LO(a) * SIM_HI(b) + SIM_HI(a) * SIM_LO(b);
+}
+static inline uint32_t SIM_SMLAD( uint32_t a, uint32_t b, uint32_t acc )
+{
+  return acc + (uint32_t)(SIM_LO(a) * SIM_LO(b)) + (uint32_t)(SIM_HI(a) * SIM_HI(b));
+}
+static inline uint64_t SIM_SMLALD( uint32_t a, uint32_t b, uint64_t acc )
+{
+  return acc + (uint64_t)((int64_t)SIM_LO(a) * SIM_LO(b) + (int64_t)SIM_HI(a) * SIM_HI(b));
+}
+static inline uint32_t SIM_SHADD16( uint32_t a, uint32_t b )
+{
+  return SIM_PACK16((SIM_LO(a) + SIM_LO(b)) >> 1, (SIM_HI(a) + SIM_HI(b)) >> 1);
+}
+static inline uint32_t SIM_SHSUB16( uint32_t a, uint32_t b )
+{
+  return SIM_PACK16((SIM_LO(a) - SIM_LO(b)) >> 1, (SIM_HI(a) - SIM_HI(b)) >> 1);
+}
+static inline uint32_t SIM_QADD16( uint32_t a, uint32_t b )
+{
+  return SIM_PACK16(SIM_SAT16(SIM_LO(a) + SIM_LO(b)), SIM_SAT16(SIM_HI(a) + SIM_HI(b)));
+}
+static inline uint32_t SIM_SSUB16( uint32_t a, uint32_t b )
+{
+  int32_t lo = SIM_LO(a) - SIM_LO(b);
+  int32_t hi = SIM_HI(a) - SIM_HI(b);
+
+  SIM_GE = ((lo >= 0) ? 0x3 : 0) | ((hi >= 0) ? 0xC : 0);
+  return SIM_PACK16(lo, hi);
+}
+static inline uint32_t SIM_USUB16( uint32_t a, uint32_t b )
+{
+  SIM_GE = ((SIM_ULO(a) >= SIM_ULO(b)) ? 0x3 : 0) | ((SIM_UHI(a) >= SIM_UHI(b)) ? 0xC : 0);
+  return SIM_PACK16(SIM_ULO(a) - SIM_ULO(b), SIM_UHI(a) - SIM_UHI(b));
+}
+static inline uint32_t SIM_UADD16( uint32_t a, uint32_t b )
+{
+  uint32_t lo = SIM_ULO(a) + SIM_ULO(b);
+  uint32_t hi = SIM_UHI(a) + SIM_UHI(b);
+
+  SIM_GE = ((lo > 0xFFFF) ? 0x3 : 0) | ((hi > 0xFFFF) ? 0xC : 0);
+  return SIM_PACK16(lo, hi);
+}
+static inline uint32_t SIM_SEL( uint32_t a, uint32_t b )
+{
+  uint32_t mask = ((SIM_GE & 0x1) ? 0x000000FF : 0) | ((SIM_GE & 0x2) ? 0x0000FF00 : 0) |
+                  ((SIM_GE & 0x4) ? 0x00FF0000 : 0) | ((SIM_GE & 0x8) ? 0xFF000000 : 0);
+
+  return (a & mask) | (b & ~mask);
+}
+static inline uint32_t SIM_ROR( uint32_t x, uint32_t n )
+{
+  n &= 31;
+  return (n == 0) ? x : (x >> n) | (x << (32 - n));
+}
+static inline uint32_t SIM_RBIT( uint32_t x )
+{
+  uint32_t r = 0;
+
+  for(uint8_t i = 0; i < 32; i++, x >>= 1)
+    r = (r << 1) | (x & 1);
+  return r;
+}
+static inline uint8_t SIM_CLZ( uint32_t x )
+{
+  return (x == 0) ? 32 : (uint8_t)__builtin_clz(x);
+}
+static inline int32_t SIM_SSAT( int32_t x, uint32_t bits )
+{
+  int32_t max = (1L << (bits - 1)) - 1;
+
+  return (x > max) ? max : (x < -max - 1) ? -max - 1 : x;
+}
+
+#undef  __SMUSD
+#define __SMUSD     SIM_SMUSD
+#undef  __SMUADX
+#define __SMUADX    SIM_SMUADX
+#undef  __SMLAD
+#define __SMLAD     SIM_SMLAD
+#undef  __SMLALD
+#define __SMLALD    SIM_SMLALD
+#undef  __SHADD16
+#define __SHADD16   SIM_SHADD16
+#undef  __SHSUB16
+#define __SHSUB16   SIM_SHSUB16
+#undef  __QADD16
+#define __QADD16    SIM_QADD16
+#undef  __SSUB16
+#define __SSUB16    SIM_SSUB16
+#undef  __USUB16
+#define __USUB16    SIM_USUB16
+#undef  __UADD16
+#define __UADD16    SIM_UADD16
+#undef  __SEL
+#define __SEL       SIM_SEL
+#undef  __ROR
+#define __ROR       SIM_ROR
+#undef  __RBIT
+#define __RBIT      SIM_RBIT
+#undef  __CLZ
+#define __CLZ       SIM_CLZ
+#undef  __SSAT
+#define __SSAT      SIM_SSAT
+#undef  __PKHBT
+#define __PKHBT(__A, __B, __S)  (((uint32_t)(__A) & 0x0000FFFF) | (((uint32_t)(__B) << (__S)) & 0xFFFF0000))
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
@@ -0,0 +1,216 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+#include "modules\module_ssd1331.h"
+#include "applications\app_waveForm.h"
+#include "uMultimeter_ui.h"
+#include "algorithms\algorithm_fft.h"
+#include "algorithms\algorithm_trigger.h"
+
+#include "sim_ssd1331.h"
+
+#include <stdio.h>
+#include <math.h>
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define BENCH_PPM_SCALE   4
+#define BENCH_WAV_SAMPLE  (WaveFormW * 2)
+
+static const char *BenchOutDir = "out";
+static WaveForm_Struct WaveForm;
+static uint16_t fftColumn[WaveBarW];
+static int16_t spanHigh[WaveBarW];
+static int16_t spanLow[WaveBarW];
+static const int32_t benchMeas[MEAS_WAV_NUM] = {3300, -12, 1650, 2333, 12345, 49870, 1556, 389};  // mV, Hz, 0.001 %, ns
+static const int32_t benchMeasHigh[MEAS_WAV_NUM] = {24680, -1234, 11725, 13020, 1000, 50000, 812, 790};   // above 10 V
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Bench_Report
+**功能 : Flush, Print Counters per Call and Save Panel Image
+**輸入 : pName, loops
+**輸出 : None
+**使用 : Bench_Report("clear", 1);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void Bench_Report( const char *pName, uint32_t loops )
+{
+  SimOLED_Count_Struct count;
+  char fileName[256] = {0};
+
+  OLED_Flush();
+  SimOLED_GetCount(&count);
+  printf("%-14s %10.1f %10.1f %8.1f %8.1f %6.1f %6.1f %10.1f\n", pName,
+    (double)count.CmdBytes / loops, (double)count.DataBytes / loops,
+    (double)count.Transfers / loops, (double)count.Windows / loops,
+    (double)count.AccelCmds / loops, (double)count.DMATransfers / loops,
+    (double)SimOLED_BusNs(&count) / loops / 1000.0);
+
+  snprintf(fileName, sizeof(fileName), "%s/%s.ppm", BenchOutDir, pName);
+  if(SimOLED_SavePPM(fileName, BENCH_PPM_SCALE) != 0)
+    fprintf(stderr, "can't write %s\n", fileName);
+  SimOLED_ClearCount();
+}
+
+static void Bench_WaveSample( uint32_t i )
+{
+  float rad = i * 0.1f;
+  float data = 0.0f;
+
+  for(uint8_t k = 1; k < 10; k = k + 2)
+    data += (1.0f / k) * sinf(k * rad);
+  WaveForm.Data[0] = sinf(rad) * 2300;
+  WaveForm.Data[1] = data * 2300;
+  UM_UI_modeWAV_ALL(&WaveForm);
+  OLED_Flush();
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
+int main( int argc, char **argv )
+{
+  if(argc > 1)
+    BenchOutDir = argv[1];
+
+  SimOLED_Reset();
+  SSD1331_Config();
+  SSD1331_Init();
+
+  WaveForm.Channel       = 2;
+  WaveForm.WindowColor   = WHITE;
+  WaveForm.BackColor     = BLACK;
+  WaveForm.Scale[0]      = 100;
+  WaveForm.Scale[1]      = 100;
+  WaveForm.PointColor[0] = GREEN;
+  WaveForm.PointColor[1] = BLUE;
+  WaveForm.Roll          = ENABLE;
+  WaveFormInit(&WaveForm);
+  OLED_Clear(BLACK);
+  OLED_Flush();
+  SimOLED_ClearCount();
+
+  printf("%-14s %10s %10s %8s %8s %6s %6s %10s\n", "case", "cmd B", "data B", "CS", "window", "accel", "DMA", "bus us");
+
+  OLED_Clear(BLACK);
+  Bench_Report("clear", 1);
+
+  OLED_TestColoBar();
+  Bench_Report("colorbar", 1);
+
+  OLED_TestSPI();
+  Bench_Report("spi_test", 1);
+
+  OLED_Clear(BLACK);
+  OLED_Flush();
+  SimOLED_ClearCount();
+  OLED_PutStr_5x7(2, 2, "uMultimeter 0123", WHITE, BLACK);
+  Bench_Report("str_5x7", 1);
+
+  OLED_PutStr(2, 12, "SSD1331", YELLOW, BLACK);
+  Bench_Report("str_12x6", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_VOL, MODE_VOL_CH1));
+  Bench_Report("menu", 1);
+
+  UM_UI_modeVOL_Init(MODE_VOL_CH1);
+  Bench_Report("vol_init", 1);
+
+  UM_UI_modeVOL(7712, 37520, 3301000, 4);
+  Bench_Report("vol_update", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_VOL, MODE_VOL_CH1));
+  UM_UI_modeVOL(7712, 37520, 3301000, 4);
+  Bench_Report("vol_steady", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_VOL, MODE_VOL_CH1));
+  UM_UI_modeVOL(7714, 37520, 3302000, 4);
+  Bench_Report("vol_step", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_VOL, MODE_VOL_CH1));
+  UM_UI_modeVOL(7714, 37520, 3302000, 4);
+  UM_UI_modeVOL_putStatus(3296, 312);
+  Bench_Report("vol_status", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_VOL, MODE_VOL_CH1));
+  UM_UI_modeVOL_putCalib(1, 12);
+  UM_UI_modeVOL(7714, 37520, 3302000, 4);
+  Bench_Report("vol_calib", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_VOL, MODE_VOL_CH1));
+  UM_UI_modeVOL_putCalib(0, 0);
+  UM_UI_modeVOL(7714, 37520, 3302000, 4);
+  UM_UI_modeVOL_putStatus(3296, 312);
+  Bench_Report("vol_calib_end", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_VOL, MODE_VOL_AC));
+  UM_UI_modeVOL_Init(MODE_VOL_AC);
+  UM_UI_modeVOL(50, 141, 230150, 3);
+  UM_UI_modeVOL_putPhase(3296, 1207);
+  Bench_Report("vol_phase", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_PWM, MODE_PWM_OUT));
+  UM_UI_modePWM_Init(MODE_PWM_OUT);
+  UM_UI_modePWM(2500, 1000);
+  Bench_Report("pwm_init", 1);
+
+  UM_UI_modePWM(2500, 1000);
+  Bench_Report("pwm_steady", 1);
+
+  UM_UI_modePWM(7500, 1000);
+  Bench_Report("pwm_step", 1);
+
+  UM_UI_modePWM(1000, 1000);
+  Bench_Report("pwm_fall", 1);
+
+  OLED_SetColorMode(OLED_COLOR_256);
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_WAV, MODE_WAV_ALL));
+  UM_UI_modeWAV_Init(MODE_WAV_ALL);
+  WaveForm.Redraw = ENABLE;
+  Bench_Report("wav_init", 1);
+
+  for(uint32_t i = 0; i < BENCH_WAV_SAMPLE; i++)
+    Bench_WaveSample(i);
+  Bench_Report("wav_sample", BENCH_WAV_SAMPLE);
+
+  OLED_SetColorMode(OLED_COLOR_65K);
+  for(uint32_t i = 0; i < BENCH_WAV_SAMPLE; i++)
+    Bench_WaveSample(i);
+  Bench_Report("wav_sample65k", BENCH_WAV_SAMPLE);
+
+  OLED_SetColorMode(OLED_COLOR_256);
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_WAV, MODE_WAV_FFT));
+  UM_UI_modeWAV_Init(MODE_WAV_FFT);
+  WaveForm.Redraw = ENABLE;
+  for(uint32_t i = 0; i < WaveBarW; i++)   // noise floor
+    fftColumn[i] = (1 << 8) + (i * 37 % 5) * 48;
+  for(uint32_t h = 1; h < 12; h += 2)       // 1 kHz square wave, odd harmonics, 3.67 columns per kHz
+    fftColumn[(h * 367 + 50) / 100] = FFT_LOG_FULL - h * 256;
+  UM_UI_modeWAV_FFT(&WaveForm, fftColumn, 4, 1000);
+  Bench_Report("wav_fft", 1);
+
+  UM_UI_menuDisplay(Byte16(uint32_t, MODE_WAV, MODE_WAV_CH1));
+  UM_UI_modeWAV_Init(MODE_WAV_CH1);
+  WaveForm.Redraw = ENABLE;
+  for(uint32_t i = 0; i < WaveBarW; i++) {  // 4 samples per column, one sample spike at column 60
+    spanHigh[i] = -32768;
+    spanLow[i]  = 32767;
+    for(uint32_t k = 0; k < 4; k++) {
+      int16_t data = sinf((i * 4 + k) * 0.05f) * 1800 + ((i == 60) && (k == 2) ? 2000 : 0);
+      if(data > spanHigh[i]) spanHigh[i] = data;
+      if(data < spanLow[i])  spanLow[i]  = data;
+    }
+  }
+  UM_UI_modeWAV_CH1(&WaveForm, spanHigh, spanLow, benchMeas, 2, 500, TRIG_STATE_TRIG);
+  Bench_Report("wav_meas", 1);
+
+  UM_UI_modeWAV_CH1(&WaveForm, NULL, spanLow, benchMeas, 2, 14000, TRIG_STATE_WAIT);   // level above the window
+  Bench_Report("wav_trig_top", 1);
+
+  UM_UI_modeWAV_CH1(&WaveForm, NULL, spanLow, benchMeasHigh, 0, 14000, TRIG_STATE_WAIT);
+  Bench_Report("wav_volt_max", 1);
+
+  UM_UI_modeWAV_CH1(&WaveForm, NULL, spanLow, benchMeasHigh, 1, 14000, TRIG_STATE_WAIT);
+  Bench_Report("wav_volt_avg", 1);
+
+  return 0;
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
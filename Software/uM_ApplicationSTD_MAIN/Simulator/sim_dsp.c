@@ -0,0 +1,289 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+#include "algorithms\algorithm_fft.h"
+#include "algorithms\algorithm_trigger.h"
+#include "algorithms\algorithm_measure.h"
+#include "algorithms\algorithm_peak.h"
+#include "algorithms\algorithm_rms.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define CHECK_RING_SIZE   2048
+
+static Fft_Struct Fft;
+static Meas_Struct Meas;
+static Peak_Struct Peak;
+static uint16_t Ring[CHECK_RING_SIZE];
+static uint32_t CheckFail = 0;
+
+/* WaveWork of uMultimeter.c, FFT and peak cells on the same storage */
+static union {
+  Fft_Struct  Fft;
+  Peak_Struct Peak;
+} Work;
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : Check_Report
+**功能 : Print a Result against its Float Reference
+**輸入 : pName, value, ref, tol
+**輸出 : None
+**使用 : Check_Report("meas_period", 300.4, 300.5, 0.5);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void Check_Report( const char *pName, double value, double ref, double tol )
+{
+  uint8_t pass = (fabs(value - ref) <= tol);
+
+  printf("%-18s %12.3f %12.3f %10.3f  %s\n", pName, value, ref, tol, pass ? "ok" : "FAIL");
+  if(!pass)
+    CheckFail++;
+}
+
+static uint16_t Check_Code( double data )
+{
+  long code = lrint(data);
+
+  return (code < 0) ? 0 : (code > TRIG_CODE_MAX) ? TRIG_CODE_MAX : (uint16_t)code;
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
+/* a tone between bins, the peak bin and its level against a float DFT of the same windowed input */
+static void Check_Fft( uint16_t size, double bin, double amp )
+{
+  double mean = 0.0;
+  double re = 0.0;
+  double im = 0.0;
+  double win = 0.0;
+  double ref = 0.0;
+  char name[32] = {0};
+  uint32_t peak = 0;
+  uint16_t k = 0;
+
+  Fft_Init(&Fft, size);
+  for(uint16_t n = 0; n < size; n++) {
+    Ring[n] = Check_Code(2048 + amp * sin(2 * M_PI * bin * n / size));
+    mean += Ring[n] * 4.0 / size;
+  }
+  Fft_Load(&Fft, Ring);
+  Fft_Run(&Fft);
+  peak = Fft_Peak(&Fft);
+  k = peak >> 8;
+
+  /* q14 samples, one halving per radix-2 stage, the split keeps the scale, X[k] / (size / 2) */
+  for(uint16_t n = 0; n < size; n++) {
+    win = Fft.Window[(n < size / 2) ? n : size - 1 - n] / 32768.0;
+    re += (Ring[n] * 4.0 - mean) * win * cos(2 * M_PI * k * n / size);
+    im -= (Ring[n] * 4.0 - mean) * win * sin(2 * M_PI * k * n / size);
+  }
+  ref = log2((re * re + im * im) / ((double)size * size / 4));
+
+  snprintf(name, sizeof(name), "fft%u_bin", size);
+  Check_Report(name, peak / 256.0, bin, 0.05);
+  snprintf(name, sizeof(name), "fft%u_log2", size);
+  Check_Report(name, Fft.Log[k] / 256.0, ref, 0.25);
+}
+
+/* modeWAV_Init of CH1 then FFT, a tone through the FFT set up after the peak cells were in use */
+static void Check_WaveInit( void )
+{
+  const uint16_t size = 1024;
+  const double bin = 100.5;
+
+  Peak_Start(&Work.Peak, 0);
+  for(uint16_t i = 0; i < CHECK_RING_SIZE; i++)
+    Ring[i] = rand() & TRIG_CODE_MAX;
+  Peak_Start(&Work.Peak, PEAK_DEPTH_MAX);
+  Peak_Push(&Work.Peak, Ring, PEAK_DEPTH_MAX);
+  Peak_Cells(&Work.Peak, PEAK_LEVEL_MAX);
+
+  Fft_Init(&Work.Fft, size);
+  for(uint16_t n = 0; n < size; n++)
+    Ring[n] = Check_Code(2048 + 2000 * sin(2 * M_PI * bin * n / size));
+  Fft_Load(&Work.Fft, Ring);
+  Fft_Run(&Work.Fft);
+
+  Check_Report("wave_init_fft_bin", Fft_Peak(&Work.Fft) / 256.0, bin, 0.05);
+}
+
+/* trapezoid, edges and levels known, two pushes split off the 8-sample blocks */
+static void Check_Meas( void )
+{
+  const double period = 300.5;
+  const double rise = 20.0;
+  const double high = 120.0;
+  const double fall = 40.0;
+  const uint16_t lens = 2048;
+  double t = 0.0;
+  double v = 0.0;
+  double sum = 0.0;
+  uint16_t max = 0;
+  uint16_t min = TRIG_CODE_MAX;
+
+  for(uint16_t i = 0; i < lens; i++) {
+    t = fmod(i + 37.3, period);
+    if(t < rise)                    v = t / rise;
+    else if(t < rise + high)        v = 1.0;
+    else if(t < rise + high + fall) v = 1.0 - (t - rise - high) / fall;
+    else                            v = 0.0;
+    Ring[i] = Check_Code(500 + 3000 * v);
+    sum += Ring[i];
+    if(Ring[i] > max) max = Ring[i];
+    if(Ring[i] < min) min = Ring[i];
+  }
+
+  /* the first pass only finds the levels */
+  Meas_Init(&Meas);
+  for(uint8_t pass = 0; pass < 2; pass++) {
+    Meas_Start(&Meas);
+    Meas_Push(&Meas, Ring, 777);
+    Meas_Push(&Meas, Ring + 777, lens - 777);
+    Meas_Finish(&Meas);
+  }
+
+  Check_Report("meas_max", Meas.Result.Max, max, 0);
+  Check_Report("meas_min", Meas.Result.Min, min, 0);
+  Check_Report("meas_mean", Meas.Result.Mean / 256.0, sum / lens, 0.5);
+  Check_Report("meas_period", Meas.Result.Period / 256.0, period, period * 0.002);
+  Check_Report("meas_duty", Meas.Result.Duty / 10.0, (rise / 2 + high + fall / 2) * 100 / period, 0.5);
+  Check_Report("meas_rise", Meas.Result.Rise / 256.0, rise * 0.8, 1.0);
+  Check_Report("meas_fall", Meas.Result.Fall / 256.0, fall * 0.8, 1.0);
+}
+
+/* random ring, a wrap splits the capture, every level against brute force */
+static void Check_Peak( void )
+{
+  const uint16_t depth = 752;
+  const uint8_t cols = 94;
+  uint16_t pMax[94] = {0};
+  uint16_t pMin[94] = {0};
+  uint32_t bad = 0;
+  uint16_t first = 0;
+  uint16_t start = 0;
+  uint16_t num = 0;
+  uint16_t cell = 0;
+  uint16_t hi = 0;
+  uint16_t lo = 0;
+  uint16_t v = 0;
+
+  srand(1);
+  for(uint16_t trial = 0; trial < 200; trial++) {
+    for(uint16_t i = 0; i < CHECK_RING_SIZE; i++)
+      Ring[i] = rand() & TRIG_CODE_MAX;
+    first = rand() & (CHECK_RING_SIZE - 1);
+
+    Peak_Start(&Peak, depth);
+    start = first;
+    num = depth;
+    if(start + num > CHECK_RING_SIZE) {
+      Peak_Push(&Peak, &Ring[start], CHECK_RING_SIZE - start);
+      num -= CHECK_RING_SIZE - start;
+      start = 0;
+    }
+    Peak_Push(&Peak, &Ring[start], num);
+
+    for(uint8_t level = PEAK_LEVEL_MAX; level >= PEAK_LEVEL_MIN; level--) {
+      cell = rand() % (Peak_Cells(&Peak, level) - cols + 1);
+      Peak_Columns(&Peak, level, cell, pMax, pMin, cols);
+      for(uint8_t c = 0; c < cols; c++) {
+        hi = 0;
+        lo = TRIG_CODE_MAX;
+        for(uint16_t k = 0; k < (1 << level); k++) {
+          v = Ring[(first + (cell + c) * (1 << level) + k) & (CHECK_RING_SIZE - 1)];
+          if(v > hi) hi = v;
+          if(v < lo) lo = v;
+        }
+        if((pMax[c] != hi) || (pMin[c] != lo))
+          bad++;
+      }
+    }
+  }
+
+  Check_Report("peak_mismatch", bad, 0, 0);
+}
+
+/* flat, then a ramp through Level, the index is known from the ramp */
+static void Check_Trig( void )
+{
+  Trig_Struct trig;
+  const uint16_t level = 2000;
+  const uint16_t slope = 37;
+  uint32_t bad = 0;
+  uint32_t index = 0;
+  uint32_t expect = 0;
+  uint32_t split = 0;
+
+  for(uint8_t edge = 0; edge < 2; edge++) {
+    for(uint16_t e = 0; e < 64; e++) {
+      for(uint16_t i = 0; i < 256; i++) {
+        Ring[i] = (i < e) ? 1000 : Check_Code(1000 + (double)slope * (i - e));
+        if(edge == TRIG_EDGE_FALL)
+          Ring[i] = 4000 - Ring[i];
+      }
+      expect = e + (((edge == TRIG_EDGE_FALL) ? (4000 - level) : level) - 1000 + slope - 1) / slope;
+
+      Trig_Init(&trig, (edge == TRIG_EDGE_FALL) ? 4000 - level : level, TRIG_HYST_DEF);
+      trig.Edge = edge;
+      split = (e * 7) % 61;   // ends off the 8-sample blocks, arming carried over
+      index = Trig_Scan(&trig, Ring, split);
+      if(index == TRIG_NONE) {
+        index = Trig_Scan(&trig, Ring + split, 256 - split);
+        if(index != TRIG_NONE)
+          index += split;
+      }
+      if(index != expect)
+        bad++;
+    }
+  }
+
+  Check_Report("trig_mismatch", bad, 0, 0);
+}
+
+/* exact sums, square root against the float one */
+static void Check_Rms( void )
+{
+  int16_t data[RMS_BLOCK_MAX] = {0};
+  double sumRef = 0.0;
+  double powRef = 0.0;
+  int32_t sum = 0;
+  int64_t pow = 0;
+  uint32_t bad = 0;
+
+  for(uint8_t i = 0; i < RMS_BLOCK_MAX; i++) {
+    data[i] = RMS_ADCtoQ15(Check_Code(2048 + 1900 * sin(2 * M_PI * i / 23.0)));
+    sumRef += data[i];
+    powRef += (double)data[i] * data[i];
+  }
+  Rms_sumQ15(data, RMS_BLOCK_MAX, &sum, &pow);
+  Check_Report("rms_sum", sum, sumRef, 0);
+  Check_Report("rms_pow", (double)pow, powRef, 0);
+
+  for(uint64_t p = 1; p <= 0xFFFFFFFF; p += p / 7 + 1)
+    if(fabs(Rms_sqrtQ30(p) - sqrt((double)p)) > 1.0)
+      bad++;
+  Check_Report("rms_sqrt_mismatch", bad, 0, 0);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
+int main( void )
+{
+  printf("%-18s %12s %12s %10s\n", "case", "result", "reference", "tol");
+
+  Check_Fft(256, 20.3, 1800);
+  Check_Fft(1024, 100.5, 2000);
+  Check_Fft(1024, 333.25, 300);
+  Check_Meas();
+  Check_Peak();
+  Check_Trig();
+  Check_Rms();
+  Check_WaveInit();
+
+  printf("%u failed\n", CheckFail);
+
+  return (CheckFail != 0);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
@@ -0,0 +1,201 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include "drivers\stm32f3_system.h"
+#include "drivers\stm32f3_spi.h"
+
+#include "sim_ssd1331.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define SIM_CORE_FREQ   72000000
+
+#define SIM_CS_PORT     GPIOA
+#define SIM_CS_PIN      GPIO_Pin_15
+#define SIM_DC_PORT     GPIOB
+#define SIM_DC_PIN      GPIO_Pin_4
+#define SIM_RST_PORT    GPIOB
+#define SIM_RST_PIN     GPIO_Pin_6
+
+uint32_t SystemCoreClock = SIM_CORE_FREQ;
+CoreDebug_Type SIM_CoreDebug;
+
+static DWT_Type SimDWT;
+static uint64_t SimCycles = 0;
+static uint8_t  SimPinCS = 1, SimPinDC = 0, SimPinRST = 1;
+static uint16_t SimDataSize = SPI_DataSize_8b;
+static uint8_t  SimDMABusy = 0;
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SIM_DWT
+**功能 : Cycle Counter, Advances with Modelled SPI Time and on Every Read
+**輸入 : None
+**輸出 : pDWT
+**使用 : tick = DWT->CYCCNT;
+**====================================================================================================*/
+/*====================================================================================================*/
+DWT_Type *SIM_DWT( void )
+{
+  SimCycles += 1;
+  SimDWT.CYCCNT = (uint32_t)SimCycles;
+
+  return &SimDWT;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SIM_GPIO_Write
+**功能 : GPIO Output to Virtual Panel
+**輸入 : GPIOx, pin, state
+**輸出 : None
+**使用 : SIM_GPIO_Write(GPIOA, GPIO_Pin_15, 0);
+**====================================================================================================*/
+/*====================================================================================================*/
+void SIM_GPIO_Write( GPIO_TypeDef *GPIOx, uint16_t pin, uint8_t state )
+{
+  if((GPIOx == SIM_CS_PORT) && (pin == SIM_CS_PIN))
+    SimPinCS = state;
+  else if((GPIOx == SIM_DC_PORT) && (pin == SIM_DC_PIN))
+    SimPinDC = state;
+  else if((GPIOx == SIM_RST_PORT) && (pin == SIM_RST_PIN))
+    SimPinRST = state;
+  else
+    return;
+
+  SimOLED_Pin(SimPinCS, SimPinDC, SimPinRST);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
+static void SimSPI_Frame( uint16_t data, uint8_t bits )
+{
+  if(bits == 16) {
+    SimOLED_Byte(Byte8H(data));
+    SimOLED_Byte(Byte8L(data));
+  }
+  else {
+    SimOLED_Byte(Byte8L(data));
+  }
+  SimCycles += (uint64_t)bits * SIM_CORE_FREQ / SIM_SCK_FREQ;
+}
+
+uint8_t SPI_RW8( SPI_TypeDef *SPIx, uint8_t writeByte )
+{
+  SimSPI_Frame(writeByte, 8);
+
+  return 0xFF;
+}
+
+uint16_t SPI_RW( SPI_TypeDef *SPIx, uint16_t writeByte )
+{
+  SPI_Write16(SPIx, writeByte);
+
+  return 0xFFFF;
+}
+
+void SPI_Write8( SPI_TypeDef *SPIx, uint8_t writeByte )
+{
+  SimSPI_Frame(writeByte, 8);
+}
+
+void SPI_Write16( SPI_TypeDef *SPIx, uint16_t writeData )
+{
+  /* 8-bit frames pack a half-word LSB first */
+  if(SimDataSize == SPI_DataSize_16b) {
+    SimSPI_Frame(writeData, 16);
+  }
+  else {
+    SimSPI_Frame(Byte8L(writeData), 8);
+    SimSPI_Frame(Byte8H(writeData), 8);
+  }
+}
+
+void SPI_WaitTx( SPI_TypeDef *SPIx )
+{
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SPI_DMA_Send
+**功能 : Transfer Completes Immediately, Callback Runs as from the DMA IRQ
+**輸入 : pData, lens, memInc, pCallback
+**輸出 : None
+**使用 : SPI_DMA_Send(pBuf, 96, ENABLE, NULL);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void SimSPI_DMA( const void *pData, uint16_t lens, FunctionalState memInc, uint8_t width, pFunc pCallback )
+{
+  const uint8_t  *pByte = (const uint8_t *)pData;
+  const uint16_t *pHalf = (const uint16_t *)pData;
+
+  while(SimDMABusy);
+  SimDMABusy = 1;
+  SimOLED_DMA();
+
+  for(uint16_t i = 0; i < lens; i++) {
+    uint16_t idx = (memInc == ENABLE) ? i : 0;
+    if(width == 8)
+      SimSPI_Frame(pByte[idx], 8);
+    else
+      SPI_Write16(NULL, pHalf[idx]);
+  }
+
+  SimDMABusy = 0;
+  if(pCallback != NULL)
+    pCallback();
+}
+
+void SPI_DMA_Config( SPI_TypeDef *SPIx )
+{
+}
+
+void SPI_DMA_Send( const void *pData, uint16_t lens, FunctionalState memInc, pFunc pCallback )
+{
+  SimSPI_DMA(pData, lens, memInc, 16, pCallback);
+}
+
+void SPI_DMA_Send8( const void *pData, uint16_t lens, FunctionalState memInc, pFunc pCallback )
+{
+  SimSPI_DMA(pData, lens, memInc, 8, pCallback);
+}
+
+uint8_t SPI_DMA_isBusy( void )
+{
+  return SimDMABusy;
+}
+
+void SPI_DMA_IRQHandler( void )
+{
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
+void SPI_DataSizeConfig( SPI_TypeDef *SPIx, uint16_t SPI_DataSize )
+{
+  SimDataSize = SPI_DataSize;
+}
+
+void SPI_Init( SPI_TypeDef *SPIx, SPI_InitTypeDef *SPI_InitStruct )
+{
+  SimDataSize = SPI_InitStruct->SPI_DataSize;
+}
+
+void SPI_Cmd( SPI_TypeDef *SPIx, FunctionalState NewState ) {}
+void SPI_RxFIFOThresholdConfig( SPI_TypeDef *SPIx, uint16_t SPI_RxFIFOThreshold ) {}
+void GPIO_Init( GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct ) {}
+void GPIO_PinAFConfig( GPIO_TypeDef *GPIOx, uint16_t GPIO_PinSource, uint8_t GPIO_AF ) {}
+void RCC_APB1PeriphClockCmd( uint32_t RCC_APB1Periph, FunctionalState NewState ) {}
+
+void RCC_GetClocksFreq( RCC_ClocksTypeDef *RCC_Clocks )
+{
+  RCC_Clocks->SYSCLK_Frequency = SIM_CORE_FREQ;
+  RCC_Clocks->HCLK_Frequency   = SIM_CORE_FREQ;
+  RCC_Clocks->PCLK1_Frequency  = SIM_CORE_FREQ / 2;
+  RCC_Clocks->PCLK2_Frequency  = SIM_CORE_FREQ;
+}
+
+uint32_t HAL_GetTick( void )
+{
+  return (uint32_t)(SimCycles / (SIM_CORE_FREQ / 1000));
+}
+
+void HAL_Delay( __IO uint32_t Delay )
+{
+  SimCycles += (uint64_t)Delay * (SIM_CORE_FREQ / 1000);
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
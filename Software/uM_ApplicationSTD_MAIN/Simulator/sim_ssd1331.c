@@ -0,0 +1,343 @@
+/*====================================================================================================*/
+/*====================================================================================================*/
+#include <stdio.h>
+#include <string.h>
+
+#include "sim_ssd1331.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  uint8_t  cs;
+  uint8_t  dc;
+  uint8_t  on;
+  uint8_t  fill;
+  uint8_t  remap;
+  uint8_t  colS, colE, col;
+  uint8_t  rowS, rowE, row;
+  uint8_t  cmd;
+  uint8_t  argNum;
+  uint8_t  argIdx;
+  uint8_t  arg[32];
+  uint8_t  dataHi;
+  uint8_t  dataIdx;
+} SimOLED_State_Struct;
+
+static uint16_t SimOLED_GDDRAM[SIM_OLED_H][SIM_OLED_W];
+static SimOLED_State_Struct SimOLED;
+static SimOLED_Count_Struct SimCount;
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_ArgNum
+**功能 : Number of Parameter Bytes after a Command
+**輸入 : cmd
+**輸出 : num
+**使用 : num = SimOLED_ArgNum(0x15);
+**====================================================================================================*/
+/*====================================================================================================*/
+static uint8_t SimOLED_ArgNum( uint8_t cmd )
+{
+  switch(cmd) {
+    case 0x15:  case 0x75:  return 2;   // column / row address
+    case 0x21:  return 7;               // draw line
+    case 0x22:  return 10;              // draw rectangle
+    case 0x23:  return 6;               // copy
+    case 0x24:  case 0x25:  return 4;   // dim / clear window
+    case 0x26:  return 1;               // fill enable
+    case 0x27:  return 5;               // scrolling setup
+    case 0xAB:  return 5;               // dim mode setting
+    case 0xB8:  return 32;              // gray scale table
+    case 0x81:  case 0x82:  case 0x83:  case 0x87:
+    case 0x8A:  case 0x8B:  case 0x8C:
+    case 0xA0:  case 0xA1:  case 0xA2:  case 0xA8:  case 0xAD:
+    case 0xB0:  case 0xB1:  case 0xB3:  case 0xBB:  case 0xBE:  case 0xFD:
+      return 1;
+    default:    return 0;
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_Color
+**功能 : Drawing Command Color (C, B, A) to RGB565
+**輸入 : pArg
+**輸出 : color
+**使用 : color = SimOLED_Color(&arg[4]);
+**====================================================================================================*/
+/*====================================================================================================*/
+static uint16_t SimOLED_Color( const uint8_t *pArg )
+{
+  return (uint16_t)((((pArg[0] >> 1) & 0x1F) << 11) | ((pArg[1] & 0x3F) << 5) | ((pArg[2] >> 1) & 0x1F));
+}
+
+static void SimOLED_Set( int16_t posX, int16_t posY, uint16_t color )
+{
+  if((posX >= 0) && (posX < SIM_OLED_W) && (posY >= 0) && (posY < SIM_OLED_H))
+    SimOLED_GDDRAM[posY][posX] = color;
+}
+
+static void SimOLED_Fill( uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint16_t color )
+{
+  for(int16_t i = y1; i <= y2; i++)
+    for(int16_t j = x1; j <= x2; j++)
+      SimOLED_Set(j, i, color);
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_Execute
+**功能 : Execute a Complete Command
+**輸入 : None
+**輸出 : None
+**使用 : SimOLED_Execute();
+**====================================================================================================*/
+/*====================================================================================================*/
+static void SimOLED_Execute( void )
+{
+  uint8_t *pArg = SimOLED.arg;
+
+  switch(SimOLED.cmd) {
+    case 0x15:
+      SimOLED.colS = pArg[0];
+      SimOLED.colE = pArg[1];
+      SimOLED.col  = pArg[0];
+      SimCount.Windows++;
+      break;
+    case 0x75:
+      SimOLED.rowS = pArg[0];
+      SimOLED.rowE = pArg[1];
+      SimOLED.row  = pArg[0];
+      break;
+    case 0x21: {
+      int16_t x = pArg[0], y = pArg[1];
+      int16_t dx = (pArg[2] > x) ? pArg[2] - x : x - pArg[2];
+      int16_t dy = (pArg[3] > y) ? pArg[3] - y : y - pArg[3];
+      int16_t sx = (pArg[2] > x) ? 1 : -1;
+      int16_t sy = (pArg[3] > y) ? 1 : -1;
+      int16_t err = dx - dy, e2 = 0;
+      uint16_t color = SimOLED_Color(&pArg[4]);
+      while(1) {
+        SimOLED_Set(x, y, color);
+        if((x == pArg[2]) && (y == pArg[3]))
+          break;
+        e2 = err << 1;
+        if(e2 > -dy) { err -= dy; x += sx; }
+        if(e2 <  dx) { err += dx; y += sy; }
+      }
+      SimCount.AccelCmds++;
+      break;
+    }
+    case 0x22: {
+      uint16_t line = SimOLED_Color(&pArg[4]);
+      if(SimOLED.fill & 0x01)
+        SimOLED_Fill(pArg[0], pArg[1], pArg[2], pArg[3], SimOLED_Color(&pArg[7]));
+      SimOLED_Fill(pArg[0], pArg[1], pArg[2], pArg[1], line);
+      SimOLED_Fill(pArg[0], pArg[3], pArg[2], pArg[3], line);
+      SimOLED_Fill(pArg[0], pArg[1], pArg[0], pArg[3], line);
+      SimOLED_Fill(pArg[2], pArg[1], pArg[2], pArg[3], line);
+      SimCount.AccelCmds++;
+      break;
+    }
+    case 0x23: {
+      static uint16_t tmp[SIM_OLED_H][SIM_OLED_W];
+      memcpy(tmp, SimOLED_GDDRAM, sizeof(tmp));
+      for(int16_t i = 0; i <= pArg[3] - pArg[1]; i++)
+        for(int16_t j = 0; j <= pArg[2] - pArg[0]; j++)
+          if((pArg[1] + i < SIM_OLED_H) && (pArg[0] + j < SIM_OLED_W))
+            SimOLED_Set(pArg[4] + j, pArg[5] + i, tmp[pArg[1] + i][pArg[0] + j]);
+      SimCount.AccelCmds++;
+      break;
+    }
+    case 0x24:
+      for(int16_t i = pArg[1]; (i <= pArg[3]) && (i < SIM_OLED_H); i++)
+        for(int16_t j = pArg[0]; (j <= pArg[2]) && (j < SIM_OLED_W); j++)
+          SimOLED_GDDRAM[i][j] = (SimOLED_GDDRAM[i][j] >> 1) & 0x7BEF;
+      SimCount.AccelCmds++;
+      break;
+    case 0x25:
+      SimOLED_Fill(pArg[0], pArg[1], pArg[2], pArg[3], 0x0000);
+      SimCount.AccelCmds++;
+      break;
+    case 0x26:  SimOLED.fill  = pArg[0];  break;
+    case 0xA0:  SimOLED.remap = pArg[0];  break;
+    case 0xAE:  SimOLED.on = 0;           break;
+    case 0xAF:  SimOLED.on = 1;           break;
+    default:    break;
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_Data
+**功能 : Write Pixel Data to GDDRAM
+**輸入 : byte
+**輸出 : None
+**使用 : SimOLED_Data(byte);
+**====================================================================================================*/
+/*====================================================================================================*/
+static void SimOLED_Data( uint8_t byte )
+{
+  uint16_t color = 0;
+
+  if((SimOLED.remap & 0xC0) == 0x00) {
+    /* 256 colors, RGB332 */
+    color = (uint16_t)(((byte & 0xE0) << 8) | ((byte & 0x1C) << 6) | ((byte & 0x03) << 3));
+  }
+  else {
+    /* 65k colors, RGB565 MSB first */
+    if(SimOLED.dataIdx == 0) {
+      SimOLED.dataHi  = byte;
+      SimOLED.dataIdx = 1;
+      return;
+    }
+    SimOLED.dataIdx = 0;
+    color = (uint16_t)((SimOLED.dataHi << 8) | byte);
+  }
+
+  SimOLED_Set(SimOLED.col, SimOLED.row, color);
+  if(SimOLED.col++ >= SimOLED.colE) {
+    SimOLED.col = SimOLED.colS;
+    if(SimOLED.row++ >= SimOLED.rowE)
+      SimOLED.row = SimOLED.rowS;
+  }
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_Reset
+**功能 : Power on Reset State
+**輸入 : None
+**輸出 : None
+**使用 : SimOLED_Reset();
+**====================================================================================================*/
+/*====================================================================================================*/
+void SimOLED_Reset( void )
+{
+  memset(SimOLED_GDDRAM, 0, sizeof(SimOLED_GDDRAM));
+  memset(&SimOLED, 0, sizeof(SimOLED));
+  SimOLED.cs    = 1;
+  SimOLED.colE  = SIM_OLED_W - 1;
+  SimOLED.rowE  = SIM_OLED_H - 1;
+  SimOLED.remap = 0x40;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_Pin
+**功能 : Update CS, DC, RST Level
+**輸入 : cs, dc, rst
+**輸出 : None
+**使用 : SimOLED_Pin(0, 1, 1);
+**====================================================================================================*/
+/*====================================================================================================*/
+void SimOLED_Pin( uint8_t cs, uint8_t dc, uint8_t rst )
+{
+  if(rst == 0) {
+    SimOLED_Reset();
+    return;
+  }
+  if((SimOLED.cs == 1) && (cs == 0))
+    SimCount.Transfers++;
+  if(cs == 1)
+    SimOLED.dataIdx = 0;
+  SimOLED.cs = cs;
+  SimOLED.dc = dc;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_Byte
+**功能 : Byte Clocked in on SDI
+**輸入 : byte
+**輸出 : None
+**使用 : SimOLED_Byte(0xAF);
+**====================================================================================================*/
+/*====================================================================================================*/
+void SimOLED_Byte( uint8_t byte )
+{
+  if(SimOLED.cs != 0)
+    return;
+
+  if(SimOLED.dc != 0) {
+    SimCount.DataBytes++;
+    SimOLED_Data(byte);
+    return;
+  }
+
+  SimCount.CmdBytes++;
+  if(SimOLED.argIdx < SimOLED.argNum) {
+    SimOLED.arg[SimOLED.argIdx++] = byte;
+  }
+  else {
+    SimOLED.cmd    = byte;
+    SimOLED.argNum = SimOLED_ArgNum(byte);
+    SimOLED.argIdx = 0;
+  }
+  if(SimOLED.argIdx == SimOLED.argNum) {
+    SimOLED_Execute();
+    SimOLED.argNum = 0;
+    SimOLED.argIdx = 0;
+  }
+}
+
+void SimOLED_DMA( void )
+{
+  SimCount.DMATransfers++;
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_GetCount
+**功能 : Read / Clear Counters
+**輸入 : pCount
+**輸出 : None
+**使用 : SimOLED_GetCount(&count);
+**====================================================================================================*/
+/*====================================================================================================*/
+void SimOLED_GetCount( SimOLED_Count_Struct *pCount )
+{
+  *pCount = SimCount;
+}
+
+void SimOLED_ClearCount( void )
+{
+  memset(&SimCount, 0, sizeof(SimCount));
+}
+
+uint64_t SimOLED_BusNs( const SimOLED_Count_Struct *pCount )
+{
+  return (uint64_t)(pCount->CmdBytes + pCount->DataBytes) * 8 * 1000000000ULL / SIM_SCK_FREQ;
+}
+
+uint16_t SimOLED_GetPixel( uint8_t posX, uint8_t posY )
+{
+  return SimOLED_GDDRAM[posY][posX];
+}
+/*====================================================================================================*/
+/*====================================================================================================*
+**函數 : SimOLED_SavePPM
+**功能 : Dump GDDRAM as Binary PPM
+**輸入 : pFileName, scale
+**輸出 : 0 - OK, -1 - Error
+**使用 : SimOLED_SavePPM("out/clear.ppm", 4);
+**====================================================================================================*/
+/*====================================================================================================*/
+int SimOLED_SavePPM( const char *pFileName, uint8_t scale )
+{
+  FILE *pFile = fopen(pFileName, "wb");
+  uint8_t rgb[3] = {0};
+  uint16_t c = 0;
+
+  if(pFile == NULL)
+    return -1;
+  if(scale == 0)
+    scale = 1;
+
+  fprintf(pFile, "P6\n%d %d\n255\n", SIM_OLED_W * scale, SIM_OLED_H * scale);
+  for(uint16_t i = 0; i < SIM_OLED_H * scale; i++) {
+    for(uint16_t j = 0; j < SIM_OLED_W * scale; j++) {
+      c = SimOLED.on ? SimOLED_GDDRAM[i / scale][j / scale] : 0x0000;
+      rgb[0] = ((c >> 11) & 0x1F) << 3 | ((c >> 13) & 0x07);
+      rgb[1] = ((c >>  5) & 0x3F) << 2 | ((c >>  9) & 0x03);
+      rgb[2] = ((c      ) & 0x1F) << 3 | ((c >>  2) & 0x07);
+      fwrite(rgb, 1, 3, pFile);
+    }
+  }
+  fclose(pFile);
+
+  return 0;
+}
+/*====================================================================================================*/
+/*====================================================================================================*/
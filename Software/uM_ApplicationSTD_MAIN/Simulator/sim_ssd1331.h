@@ -0,0 +1,36 @@
+/* #include "sim_ssd1331.h" */
+
+#ifndef __SIM_SSD1331_H
+#define __SIM_SSD1331_H
+
+#include <stdint.h>
+/*====================================================================================================*/
+/*====================================================================================================*/
+#define SIM_OLED_W      96
+#define SIM_OLED_H      64
+#define SIM_SCK_FREQ    18000000  // SPI3, PCLK1 / 2
+/*====================================================================================================*/
+/*====================================================================================================*/
+typedef struct {
+  uint32_t CmdBytes;      // DC low bytes, commands & parameters
+  uint32_t DataBytes;     // DC high bytes, pixel data
+  uint32_t Transfers;     // CS falling edges
+  uint32_t Windows;       // column / row address commands (0x15, 0x75) pairs
+  uint32_t AccelCmds;     // draw line / rect / copy / dim / clear commands
+  uint32_t DMATransfers;  // SPI_DMA_Send calls
+} SimOLED_Count_Struct;
+/*====================================================================================================*/
+/*====================================================================================================*/
+void     SimOLED_Reset( void );
+void     SimOLED_Pin( uint8_t cs, uint8_t dc, uint8_t rst );
+void     SimOLED_Byte( uint8_t byte );
+void     SimOLED_DMA( void );
+
+void     SimOLED_GetCount( SimOLED_Count_Struct *pCount );
+void     SimOLED_ClearCount( void );
+uint64_t SimOLED_BusNs( const SimOLED_Count_Struct *pCount );
+uint16_t SimOLED_GetPixel( uint8_t posX, uint8_t posY );
+int      SimOLED_SavePPM( const char *pFileName, uint8_t scale );
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
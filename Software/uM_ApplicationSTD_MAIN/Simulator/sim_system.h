@@ -0,0 +1,18 @@
+/* #include "drivers\stm32f3_system.h" */
+
+#ifndef __SIM_SYSTEM_H
+#define __SIM_SYSTEM_H
+
+#include "stm32f3_system.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+/* GPIO writes go to the virtual panel, it needs CS / DC / RST edges */
+void SIM_GPIO_Write( GPIO_TypeDef *GPIOx, uint16_t pin, uint8_t state );
+
+#undef  __GPIO_SET
+#undef  __GPIO_RST
+#define __GPIO_SET(_PORT, _PIN)   SIM_GPIO_Write(_PORT, _PIN, 1)
+#define __GPIO_RST(_PORT, _PIN)   SIM_GPIO_Write(_PORT, _PIN, 0)
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif
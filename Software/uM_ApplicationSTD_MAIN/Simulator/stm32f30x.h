@@ -0,0 +1,20 @@
+/* #include "stm32f30x.h" */
+
+#ifndef __SIM_STM32F30X_H
+#define __SIM_STM32F30X_H
+
+/* real device header, register types & StdPeriph prototypes */
+#include_next "stm32f30x.h"
+/*====================================================================================================*/
+/*====================================================================================================*/
+/* core registers read or written by the drawing code live in host memory */
+DWT_Type *SIM_DWT( void );
+extern CoreDebug_Type SIM_CoreDebug;
+
+#undef  DWT
+#define DWT         (SIM_DWT())
+#undef  CoreDebug
+#define CoreDebug   (&SIM_CoreDebug)
+/*====================================================================================================*/
+/*====================================================================================================*/
+#endif